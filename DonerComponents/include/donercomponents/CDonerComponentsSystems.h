@@ -29,12 +29,15 @@
 
 #include <donercomponents/common/CSingleton.h>
 
+#include <cstddef>
+
 namespace DonerComponents
 {
 	class CComponentFactoryManager;
 	class CGameObjectManager;
 	class CTagsManager;
 	class CPrefabManager;
+	class CJobSystem;
 
 	class CDonerComponentsSystems : public CSingleton<CDonerComponentsSystems>
 	{
@@ -42,7 +45,9 @@ namespace DonerComponents
 		CDonerComponentsSystems();
 		~CDonerComponentsSystems();
 
-		CDonerComponentsSystems& Init();
+		// With numWorkerThreads > 0, factories registered with dependencies are updated in parallel
+		// and jobs submitted to the CJobSystem are run in the background
+		CDonerComponentsSystems& Init(std::size_t numWorkerThreads = 0);
 		void Destroy();
 		void Update(float dt);
 
@@ -50,12 +55,14 @@ namespace DonerComponents
 		CGameObjectManager* GetGameObjectManager();
 		CTagsManager* GetTagsManager();
 		CPrefabManager* GetPrefabManager();
+		CJobSystem* GetJobSystem();
 
 	private:
 		CComponentFactoryManager* m_componentFactoryManager;
 		CGameObjectManager* m_gameObjectManager;
 		CTagsManager* m_tagsManager;
 		CPrefabManager* m_prefabManager;
+		CJobSystem* m_jobSystem;
 
 		bool m_initialized;
 	};
@@ -32,4 +32,7 @@
 namespace DonerComponents
 {
 	enum class ESendMessageType { NonRecursive, Recursive };
+	enum class EUpdatePhase { PrePhysics, Physics, PostPhysics, Late, Count };
+	enum class EPostMsgDelivery { Ordered, Batched };
+	enum class EPostMsgPriority { High, Normal, Low, Count };
 }
@@ -56,7 +56,9 @@ namespace DonerComponents
 		ComponentdNotFoundInGameObject,
 		ComponentdAlreadyFoundInGameObject,
 		ComponentNotRegisteredInFactory,
-		GameObjectNotRegisteredInFactory
+		GameObjectNotRegisteredInFactory,
+		InvalidTaskDependency,
+		NameHashCollision
 	};
 
 #if defined _DEBUG
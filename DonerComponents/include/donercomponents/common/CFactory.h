@@ -29,6 +29,7 @@
 
 #include <donercomponents/common/CFactoryElement.h>
 
+#include <cstdint>
 #include <cstdio>
 #include <memory>
 #include <stdlib.h>
@@ -112,12 +113,12 @@ namespace DonerComponents
 		{
 			if (data)
 			{
-				for (std::size_t i = 0; i < m_numElements; ++i)
+				// Elements never move, so their position is their offset in the buffer
+				std::uintptr_t offset = reinterpret_cast<std::uintptr_t>(data) - reinterpret_cast<std::uintptr_t>(m_buffer);
+				std::size_t i = offset / sizeof(T);
+				if (offset % sizeof(T) == 0 && i < m_numElements && data->GetVersion() == m_entries[i].m_version)
 				{
-					if (m_entries[i].m_data == data && data->GetVersion() == m_entries[i].m_version)
-					{
-						return i;
-					}
+					return i;
 				}
 			}
 			return -1;
@@ -150,12 +151,11 @@ namespace DonerComponents
 
 		SEntry* FindElement(T* data)
 		{
-			for (SEntry& entry : m_entries)
+			std::uintptr_t offset = reinterpret_cast<std::uintptr_t>(data) - reinterpret_cast<std::uintptr_t>(m_buffer);
+			std::size_t i = offset / sizeof(T);
+			if (data && offset % sizeof(T) == 0 && i < m_numElements)
 			{
-				if (entry.m_data == data)
-				{
-					return &entry;
-				}
+				return &m_entries[i];
 			}
 			return nullptr;
 		}
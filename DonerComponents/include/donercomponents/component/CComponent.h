@@ -30,6 +30,7 @@
 #include <donercomponents/ErrorMessages.h>
 #include <donercomponents/handle/CHandle.h>
 #include <donercomponents/common/CFactoryElement.h>
+#include <donercomponents/messages/CMsgDispatchTable.h>
 #include <donercomponents/messages/CMsgHandler.h>
 #include <donercomponents/utils/hash/CTypeHasher.h>
 
@@ -37,8 +38,6 @@
 
 #include <rapidjson/document.h>
 
-#include <unordered_map>
-
 #define DONER_DECLARE_COMPONENT_AS_SERIALIZABLE(class_name)                     \
   friend struct SDonerReflectionClassProperties<class_name>;                   \
 public:                                                                        \
@@ -52,9 +51,13 @@ void base_class::ParseAtts(const rapidjson::Value &atts)					   \
 
 namespace DonerComponents
 {
+	class IComponentFactory;
+
 	class CComponent : public CFactoryElement, DonerSerializer::ISerializable
 	{
 		template<class CComponent> friend class CFactory;
+		template<typename T> friend class CComponentFactory;
+		friend class CComponentTraits;
 	public:
 		virtual ~CComponent();
 
@@ -68,18 +71,42 @@ namespace DonerComponents
 		void SetOwner(CHandle parent) { m_owner = parent; }
 		CHandle GetOwner() const { return m_owner; }
 
+		// Called only for the first component of each type to be initialized, as the registered
+		// messages are shared by all components of the same type
 		virtual void RegisterMessages() {}
 
 		template<typename T>
 		void SendMessage(const T& message)
 		{
-			if (m_initialized && IsActive() && !m_destroyed)
+			if (m_initialized && IsActive() && !m_destroyed && m_messageTable)
+			{
+				static const CTypeHasher::TypeIndex messageIdx = CTypeHasher::Index<T>();
+				CMsgHandlerBase* handler = m_messageTable->Find(messageIdx);
+				if (handler)
+				{
+					handler->Execute(this, message);
+				}
+			}
+		}
+
+		// Sends getMessage(0) to getMessage(count - 1) looking the handler up only once
+		template<typename T, typename TGetMessage>
+		void SendMessages(std::size_t count, TGetMessage getMessage)
+		{
+			if (!m_messageTable)
+			{
+				return;
+			}
+
+			static const CTypeHasher::TypeIndex messageIdx = CTypeHasher::Index<T>();
+			CMsgHandlerBase* handler = m_messageTable->Find(messageIdx);
+			if (handler)
 			{
-				static const CTypeHasher::HashId hash = CTypeHasher::Hash<T>();
-				auto registeredMsg = m_messages.find(hash);
-				if (registeredMsg != m_messages.end())
+				// A handler may deactivate or destroy the component
+				for (std::size_t i = 0; i < count && m_initialized && IsActive() && !m_destroyed; ++i)
 				{
-					(*registeredMsg).second->Execute(this, message);
+					const T& message = getMessage(i);
+					handler->Execute(this, message);
 				}
 			}
 		}
@@ -91,6 +118,11 @@ namespace DonerComponents
 		bool IsActive() const { return m_numDeactivations == 0; }
 		bool IsDestroyed() const { return m_destroyed; }
 
+		// Sleeping components aren't updated, but still receive messages
+		void Sleep();
+		void WakeUp();
+		bool IsSleeping() const { return m_sleeping; }
+
 		virtual void ParseAtts(const rapidjson::Value& /*atts*/) {}
 
 		bool GetIsInitiallyActive() const { return m_initiallyActive; }
@@ -115,38 +147,28 @@ namespace DonerComponents
 		template<typename C, typename T>
 		void RegisterMessage(void(C::*function)(T& param))
 		{
-			CTypeHasher::HashId id = CTypeHasher::Hash<T>();
-			if (m_messages.find(id) == m_messages.end())
-			{
-				m_messages[id] = new CMsgHandler<C, T>(function);
-			}
-			else
-			{
-				DC_WARNING_MSG(EErrorCode::MessageAlreadyRegistered, "The message is already registered for this component");
-			}
+			RegisterMessageHandler(CTypeHasher::Index<T>(), new CMsgHandler<C, T>(function));
 		}
 
 		template<typename C, typename T>
 		void RegisterMessage(void(C::*function)(const T& param))
 		{
-			CTypeHasher::HashId id = CTypeHasher::Hash<T>();
-			if (m_messages.find(id) == m_messages.end())
-			{
-				m_messages[id] = new CConstMsgHandler<C, T>(function);
-			}
-			else
-			{
-				DC_WARNING_MSG(EErrorCode::MessageAlreadyRegistered, "The message is already registered for this component");
-			}
+			RegisterMessageHandler(CTypeHasher::Index<T>(), new CConstMsgHandler<C, T>(function));
 		}
 
 		CHandle m_owner;
 
-		std::unordered_map<CTypeHasher::HashId, CMsgHandlerBase*> m_messages;
+	private:
+		void RegisterMessageHandler(CTypeHasher::TypeIndex messageIdx, CMsgHandlerBase* handler);
+
+	protected:
+		IComponentFactory* m_factory;
+		CMsgDispatchTable* m_messageTable;
 
 		int m_numDeactivations;
 		bool m_initialized;
 		bool m_destroyed;
 		bool m_initiallyActive;
+		bool m_sleeping;
 	};
 }
@@ -0,0 +1,61 @@
+////////////////////////////////////////////////////////////
+//
+// MIT License
+//
+// DonerComponents
+// Copyright(c) 2017 Donerkebap13
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <donercomponents/utils/hash/CTypeHasher.h>
+
+#include <vector>
+
+namespace DonerComponents
+{
+	class CComponentDependencies
+	{
+	public:
+		template<typename T>
+		CComponentDependencies& Reads()
+		{
+			m_reads.emplace_back(CTypeHasher::Hash<T>());
+			return *this;
+		}
+
+		template<typename T>
+		CComponentDependencies& Writes()
+		{
+			m_writes.emplace_back(CTypeHasher::Hash<T>());
+			return *this;
+		}
+
+		bool ConflictsWith(const CComponentDependencies& other) const;
+
+	private:
+		static bool Contains(const std::vector<CTypeHasher::HashId>& ids, CTypeHasher::HashId id);
+
+		std::vector<CTypeHasher::HashId> m_reads;
+		std::vector<CTypeHasher::HashId> m_writes;
+	};
+}
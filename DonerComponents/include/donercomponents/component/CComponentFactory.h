@@ -29,15 +29,24 @@
 
 #include <donercomponents/ErrorMessages.h>
 #include <donercomponents/common/CFactory.h>
+#include <donercomponents/component/CComponentTraits.h>
+#include <donercomponents/messages/CMsgDispatchTable.h>
+#include <donercomponents/utils/CAtomicBitMask.h>
+
+#include <chrono>
 
 namespace DonerComponents
 {
 	class CComponent;
+	class CCommandBuffer;
 	class CHandle;
 
 	class IComponentFactory
 	{
 	public:
+		IComponentFactory();
+		virtual ~IComponentFactory();
+
 		virtual CComponent* CreateComponent() = 0;
 		virtual CComponent* CreateComponent(CComponent* rhs) = 0;
 		virtual CComponent* CloneComponent(CComponent* component) = 0;
@@ -45,13 +54,67 @@ namespace DonerComponents
 		virtual int GetComponentPosition(CComponent* component) = 0;
 		virtual bool DestroyComponent(CComponent* component) = 0;
 		virtual void Update(float dt) = 0;
+		virtual bool IsUpdatable() const = 0;
+		virtual void SetComponentAwake(CComponent* component, bool awake) = 0;
+		virtual CComponent* GetComponentAt(std::size_t position) = 0;
+
+		// Pool position of the first live component from begin, or GetCapacity() if there's none
+		std::size_t GetNextLive(std::size_t begin) const { return m_liveMask.GetNextSet(begin); }
+		std::size_t GetCapacity() const { return m_liveMask.GetSize(); }
 
 		bool SetHandleInfoFromComponent(CComponent* component, CHandle& handle);
-		void ScheduleDestroyComponent(CHandle component);
+		// Scheduled components are destroyed in pool order. Scheduling one twice has no effect
+		void ScheduleDestroyComponent(CComponent* component);
 		void ExecuteScheduledDestroys();
+		bool HasScheduledDestroys() const { return m_numScheduledDestroys > 0; }
+
+		// Lets ExecuteScheduledDestroys run this factory's destructors on a worker thread, at the same
+		// time as other factories that opted in. Only for types whose destructors don't touch anything
+		// but the component itself. Disabled by default
+		void SetParallelDestroysEnabled(bool enabled) { m_parallelDestroys = enabled; }
+		bool IsParallelDestroysEnabled() const { return m_parallelDestroys; }
+
+		// With chunkSize > 0 and a CJobSystem available, Update splits the pool
+		// in chunks of chunkSize components which are updated in parallel
+		void SetUpdateChunkSize(std::size_t chunkSize) { m_updateChunkSize = chunkSize; }
+		std::size_t GetUpdateChunkSize() const { return m_updateChunkSize; }
+
+		// With a budget, each Update goes on from where the previous one stopped, updating at most
+		// maxComponents components or as many as fit in maxTime (0 means no limit on each).
+		// Every component receives the time elapsed since its own last update
+		void SetUpdateBudget(std::size_t maxComponents, std::chrono::microseconds maxTime);
+		bool HasUpdateBudget() const { return m_budgetMaxComponents > 0 || m_budgetMaxTime.count() > 0; }
 
 	protected:
-		std::vector<CHandle> m_scheduledDestroys;
+		virtual void UpdateRange(std::size_t begin, std::size_t end, float dt) = 0;
+		virtual void UpdateComponentAt(std::size_t position, float dt) = 0;
+		void UpdateInChunks(std::size_t numElements, float dt);
+		void UpdateWithBudget(std::size_t numElements, float dt);
+
+		void InitMasks(std::size_t numElements);
+		void SetAwake(std::size_t position, bool awake);
+		std::size_t GetNextAwake(std::size_t begin, std::size_t end) const { return m_awakeMask.GetNextSet(begin, end); }
+		void UnscheduleDestroy(std::size_t position);
+
+		// One bit per pool position. Atomic so components in different update chunks can sleep/wake concurrently
+		CAtomicBitMask m_liveMask;
+		CAtomicBitMask m_awakeMask;
+		CAtomicBitMask m_scheduledDestroyMask;
+		std::size_t m_numScheduledDestroys;
+		bool m_parallelDestroys;
+
+		CMsgDispatchTable m_messageTable;
+
+		std::size_t m_updateChunkSize;
+		// Pool position where each chunk of the current update starts
+		std::vector<std::size_t> m_chunkBegins;
+		std::vector<CCommandBuffer*> m_chunkCommandBuffers;
+
+		std::size_t m_budgetMaxComponents;
+		std::chrono::microseconds m_budgetMaxTime;
+		std::size_t m_budgetCursor;
+		double m_budgetTime;
+		std::vector<double> m_lastUpdateTimes;
 	};
 
 	template <typename T>
@@ -64,25 +127,31 @@ namespace DonerComponents
 	public:
 		CComponentFactory(int nElements)
 			: CFactory<T>(nElements)
-		{}
+		{
+			InitMasks(nElements);
+		}
 
 		CComponent* CreateComponent() override
 		{
-			CComponent* component = CFactory<T>::GetNewElement();
+			T* component = CFactory<T>::GetNewElement();
 			if (!component)
 			{
 				DC_ERROR_MSG(EErrorCode::NoMoreComponentsAvailable, "No more components of this kind available");
+				return nullptr;
 			}
+			OnComponentCreated(component);
 			return component;
 		}
 
 		CComponent* CreateComponent(CComponent* rhs) override
 		{
-			CComponent* component = CFactory<T>::GetNewElement(static_cast<T&>(*rhs));
+			T* component = CFactory<T>::GetNewElement(static_cast<T&>(*rhs));
 			if (!component)
 			{
 				DC_ERROR_MSG(EErrorCode::NoMoreComponentsAvailable, "No more components of this kind available");
+				return nullptr;
 			}
+			OnComponentCreated(component);
 			return component;
 		}
 
@@ -109,18 +178,108 @@ namespace DonerComponents
 		bool DestroyComponent(CComponent* component) override
 		{
 			T* tmp = static_cast<T*>(component);
-			return CFactory<T>::DestroyElement(&tmp);
+			if (CFactory<T>::DestroyElement(&tmp))
+			{
+				std::size_t position = GetPoolPosition(component);
+				m_liveMask.Set(position, false);
+				SetAwake(position, false);
+				// Destroyed before its scheduled destroy ran, so it mustn't hit whatever reuses the slot
+				UnscheduleDestroy(position);
+				return true;
+			}
+			return false;
+		}
+
+		bool IsUpdatable() const override
+		{
+			return CComponentTraits::HasUpdate<T>();
+		}
+
+		void SetComponentAwake(CComponent* component, bool awake) override
+		{
+			SetAwake(GetPoolPosition(component), awake);
+		}
+
+		CComponent* GetComponentAt(std::size_t position) override
+		{
+			return CFactory<T>::m_entries[position].m_data;
 		}
 
 		void Update(float dt) override
 		{
-			for (auto& entry : CFactory<T>::m_entries)
+			if (!CComponentTraits::HasUpdate<T>())
+			{
+				return;
+			}
+
+			if (HasUpdateBudget())
+			{
+				UpdateWithBudget(CFactory<T>::m_numElements, dt);
+			}
+			else if (m_updateChunkSize > 0)
 			{
-				if (entry.m_used)
+				UpdateInChunks(CFactory<T>::m_numElements, dt);
+			}
+			else
+			{
+				UpdateRange(0, CFactory<T>::m_numElements, dt);
+			}
+		}
+
+	protected:
+		void UpdateRange(std::size_t begin, std::size_t end, float dt) override
+		{
+			UpdateRange(begin, end, dt, std::integral_constant<bool, CComponentTraits::HasUpdateBatch<T>()>());
+		}
+
+		void UpdateComponentAt(std::size_t position, float dt) override
+		{
+			UpdateRange(position, position + 1, dt);
+		}
+
+	private:
+		void UpdateRange(std::size_t begin, std::size_t end, float dt, std::false_type /*hasUpdateBatch*/)
+		{
+			for (std::size_t i = GetNextAwake(begin, end); i < end; i = GetNextAwake(i + 1, end))
+			{
+				CFactory<T>::m_entries[i].m_data->Update(dt);
+			}
+		}
+
+		// Calls T::UpdateBatch with every run of contiguous awake and active components
+		void UpdateRange(std::size_t begin, std::size_t end, float dt, std::true_type /*hasUpdateBatch*/)
+		{
+			std::size_t runBegin = GetNextAwake(begin, end);
+			while (runBegin < end)
+			{
+				if (!CFactory<T>::m_entries[runBegin].m_data->IsActive())
+				{
+					runBegin = GetNextAwake(runBegin + 1, end);
+					continue;
+				}
+
+				std::size_t runEnd = runBegin + 1;
+				while (runEnd < end && GetNextAwake(runEnd, end) == runEnd && CFactory<T>::m_entries[runEnd].m_data->IsActive())
 				{
-					entry.m_data->Update(dt);
+					++runEnd;
 				}
+				T::UpdateBatch(CFactory<T>::m_entries[runBegin].m_data, runEnd - runBegin, dt);
+				runBegin = GetNextAwake(runEnd, end);
 			}
 		}
+
+		std::size_t GetPoolPosition(CComponent* component) const
+		{
+			return static_cast<std::size_t>(static_cast<T*>(component) - static_cast<T*>(CFactory<T>::m_buffer));
+		}
+
+		void OnComponentCreated(T* component)
+		{
+			component->m_factory = this;
+			component->m_messageTable = &m_messageTable;
+			std::size_t position = GetPoolPosition(component);
+			m_liveMask.Set(position, true);
+			SetAwake(position, !component->IsSleeping());
+		}
 	};
 }
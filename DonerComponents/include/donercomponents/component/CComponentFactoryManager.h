@@ -27,18 +27,24 @@
 
 #pragma once
 
+#include <donercomponents/Defines.h>
 #include <donercomponents/ErrorMessages.h>
+#include <donercomponents/component/CComponentDependencies.h>
 #include <donercomponents/component/CComponentFactory.h>
+#include <donercomponents/jobs/CTaskGraph.h>
 #include <donercomponents/utils/hash/CTypeHasher.h>
 #include <donercomponents/utils/hash/CStrID.h>
 
 #include <vector>
 
 #define ADD_COMPONENT_FACTORY(name, T, N) DonerComponents::CDonerComponentsSystems::Get()->GetComponentFactoryManager()->AddFactory(name, new DonerComponents::CComponentFactory<T>(N))
+#define ADD_COMPONENT_FACTORY_WITH_DEPENDENCIES(name, T, N, dependencies) DonerComponents::CDonerComponentsSystems::Get()->GetComponentFactoryManager()->AddFactory(name, new DonerComponents::CComponentFactory<T>(N), dependencies)
 
 namespace DonerComponents
 {
 	class CComponent;
+	class CCommandBuffer;
+	class CJobSystem;
 
 	class CComponentFactoryManager
 	{
@@ -49,10 +55,25 @@ namespace DonerComponents
 			CTypeHasher::HashId m_id;
 			CStrID m_nameId;
 			IComponentFactory* m_address;
-			SFactoryData() : m_id(0), m_address(nullptr) {}
-			SFactoryData(CTypeHasher::HashId id, const char* const nameId, IComponentFactory* address) : m_id(id), m_nameId(nameId), m_address(address) {}
+			CComponentDependencies m_dependencies;
+			bool m_hasDependencies;
+			EUpdatePhase m_phase;
+			SFactoryData() : m_id(0), m_address(nullptr), m_hasDependencies(false), m_phase(EUpdatePhase::PostPhysics) {}
+			SFactoryData(CTypeHasher::HashId id, const char* const nameId, IComponentFactory* address) : m_id(id), m_nameId(nameId), m_address(address), m_hasDependencies(false), m_phase(EUpdatePhase::PostPhysics) {}
+		};
+
+		struct SUpdatePhaseData
+		{
+			std::vector<std::size_t> m_factories;
+			CTaskGraph m_updateGraph;
+			float m_fixedDt;
+			float m_accumulatedDt;
+			int m_maxFixedSteps;
+			SUpdatePhaseData() : m_fixedDt(0.f), m_accumulatedDt(0.f), m_maxFixedSteps(0) {}
 		};
 	public:
+		~CComponentFactoryManager();
+
 		template<typename T>
 		bool AddFactory(const char* const factoryName, CComponentFactory<T>* factory)
 		{
@@ -60,7 +81,14 @@ namespace DonerComponents
             
 			if (!FactoryExists<T>())
 			{
+				CTypeHasher::TypeIndex typeIdx = CTypeHasher::Index<T>();
+				if (typeIdx >= m_factoryIndices.size())
+				{
+					m_factoryIndices.resize(typeIdx + 1, -1);
+				}
+				m_factoryIndices[typeIdx] = static_cast<int>(m_factories.size());
 				m_factories.emplace_back(CTypeHasher::Hash<T>(), factoryName, factory);
+				m_updateGraphDirty = true;
                 return true;
 			}
 			else
@@ -71,6 +99,71 @@ namespace DonerComponents
 			}
 		}
 
+		// Factories registered with dependencies can be updated in parallel with
+		// any other factory they don't conflict with
+		template<typename T>
+		bool AddFactory(const char* const factoryName, CComponentFactory<T>* factory, CComponentDependencies dependencies)
+		{
+			if (AddFactory(factoryName, factory))
+			{
+				SFactoryData& data = m_factories.back();
+				data.m_dependencies = dependencies.Writes<T>();
+				data.m_hasDependencies = true;
+				return true;
+			}
+			return false;
+		}
+
+		// Factories are updated in EUpdatePhase::PostPhysics unless assigned otherwise
+		template<typename T>
+		bool SetUpdatePhase(EUpdatePhase phase)
+		{
+			int factoryIdx = GetFactoryindex<T>();
+			if (factoryIdx >= 0 && phase != EUpdatePhase::Count)
+			{
+				m_factories[factoryIdx].m_phase = phase;
+				m_updateGraphDirty = true;
+				return true;
+			}
+			return false;
+		}
+
+		template<typename T>
+		bool SetUpdateChunkSize(std::size_t chunkSize)
+		{
+			IComponentFactory* factory = GetFactory<T>();
+			if (factory)
+			{
+				factory->SetUpdateChunkSize(chunkSize);
+				return true;
+			}
+			return false;
+		}
+
+		template<typename T>
+		bool SetParallelDestroysEnabled(bool enabled)
+		{
+			IComponentFactory* factory = GetFactory<T>();
+			if (factory)
+			{
+				factory->SetParallelDestroysEnabled(enabled);
+				return true;
+			}
+			return false;
+		}
+
+		template<typename T>
+		bool SetUpdateBudget(std::size_t maxComponents, std::chrono::microseconds maxTime = std::chrono::microseconds(0))
+		{
+			IComponentFactory* factory = GetFactory<T>();
+			if (factory)
+			{
+				factory->SetUpdateBudget(maxComponents, maxTime);
+				return true;
+			}
+			return false;
+		}
+
 		template<typename T>
 		CComponent* CreateComponent()
 		{
@@ -121,13 +214,10 @@ namespace DonerComponents
 		template<typename T>
 		int GetFactoryindex()
 		{
-			CTypeHasher::HashId id = CTypeHasher::Hash<T>();
-			for (std::size_t i = 0; i < m_factories.size(); ++i)
+			int factoryIdx = FindFactoryIndex<T>();
+			if (factoryIdx >= 0)
 			{
-				if (m_factories[i].m_id == id)
-				{
-					return i;
-				}
+				return factoryIdx;
 			}
 			DC_ERROR_MSG(EErrorCode::ComponentFactoryNotRegistered, "There's no factory registered to create this component");
 			return -1;
@@ -148,36 +238,52 @@ namespace DonerComponents
 
 		void Update(float dt);
 
+		// With fixedDt > 0 the phase accumulates the frame dt and is updated in steps of fixedDt,
+		// at most maxSteps times per Update. The remaining time is kept for the next Update
+		void SetFixedTimestep(EUpdatePhase phase, float fixedDt, int maxSteps = 5);
+		// Fraction of a fixed step accumulated, useful to interpolate between fixed updates
+		float GetFixedTimestepAlpha(EUpdatePhase phase) const;
+
 		void ScheduleDestroyComponent(CComponent* component);
 		void ExecuteScheduledDestroys();
 
+		// Component factories whose type registered a handler for the message, in registration order
+		void AddMessageSubscriber(CTypeHasher::TypeIndex messageIdx, IComponentFactory* factory);
+		IComponentFactory* GetMessageSubscriber(CTypeHasher::TypeIndex messageIdx, std::size_t subscriberIdx) const
+		{
+			if (messageIdx < m_messageSubscribers.size() && subscriberIdx < m_messageSubscribers[messageIdx].size())
+			{
+				return m_messageSubscribers[messageIdx][subscriberIdx];
+			}
+			return nullptr;
+		}
+
 	private:
-		CComponentFactoryManager() = default;
+		CComponentFactoryManager();
+
+		void BuildUpdatePhases();
+		void UpdatePhase(SUpdatePhaseData& phaseData, float dt, CJobSystem& jobSystem);
+
+		template<typename T>
+		int FindFactoryIndex() const
+		{
+			CTypeHasher::TypeIndex typeIdx = CTypeHasher::Index<T>();
+			return typeIdx < m_factoryIndices.size() ? m_factoryIndices[typeIdx] : -1;
+		}
 
 		template<typename T>
 		bool FactoryExists()
 		{
-			CTypeHasher::HashId id = CTypeHasher::Hash<T>();
-			for (SFactoryData& data : m_factories)
-			{
-				if (data.m_id == id)
-				{
-					return true;
-				}
-			}
-			return false;
+			return FindFactoryIndex<T>() >= 0;
 		}
 
 		template<typename T>
 		IComponentFactory* GetFactory()
 		{
-			CTypeHasher::HashId id = CTypeHasher::Hash<T>();
-			for (SFactoryData& data : m_factories)
+			int factoryIdx = FindFactoryIndex<T>();
+			if (factoryIdx >= 0)
 			{
-				if (data.m_id == id)
-				{
-					return data.m_address;
-				}
+				return m_factories[factoryIdx].m_address;
 			}
 			DC_WARNING_MSG(EErrorCode::ComponentFactoryNotRegistered, "There's no factory registered to create this component");
 			return nullptr;
@@ -187,5 +293,13 @@ namespace DonerComponents
 		IComponentFactory* GetFactoryByIndex(std::size_t idx);
 
 		std::vector<SFactoryData> m_factories;
+		// Factory index for each CTypeHasher::TypeIndex, -1 if the type has no factory
+		std::vector<int> m_factoryIndices;
+		std::vector<std::vector<IComponentFactory*>> m_messageSubscribers;
+
+		SUpdatePhaseData m_phases[static_cast<int>(EUpdatePhase::Count)];
+		std::vector<CCommandBuffer*> m_commandBuffers;
+		float m_updateDt;
+		bool m_updateGraphDirty;
 	};
 }
@@ -0,0 +1,82 @@
+////////////////////////////////////////////////////////////
+//
+// MIT License
+//
+// DonerComponents
+// Copyright(c) 2017 Donerkebap13
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+
+namespace DonerComponents
+{
+	class CComponent;
+
+	// Compile time information about component types, used by the factories
+	class CComponentTraits
+	{
+	public:
+		// False if T keeps CComponent::DoUpdate and has no UpdateBatch, so its factory doesn't need to be updated
+		template<typename T>
+		static constexpr bool HasUpdate()
+		{
+			return OverridesDoUpdate<T>(0) || HasUpdateBatch<T>();
+		}
+
+		// True if T declares a public static void UpdateBatch(T* components, std::size_t count, float dt).
+		// One inherited from a base takes base pointers, which would walk the pool with the wrong stride
+		template<typename T>
+		static constexpr bool HasUpdateBatch()
+		{
+			return DeclaresUpdateBatch<T>(0);
+		}
+
+	private:
+		// Overrides not accessible from here fall back to the second overload
+		template<typename T>
+		static constexpr auto OverridesDoUpdate(int) -> decltype(&T::DoUpdate, bool())
+		{
+			return !std::is_same<decltype(&T::DoUpdate), void (CComponent::*)(float)>::value;
+		}
+
+		template<typename T>
+		static constexpr bool OverridesDoUpdate(...)
+		{
+			return true;
+		}
+
+		template<typename T>
+		static constexpr auto DeclaresUpdateBatch(int) -> decltype(&T::UpdateBatch, bool())
+		{
+			return std::is_same<decltype(&T::UpdateBatch), void (*)(T*, std::size_t, float)>::value;
+		}
+
+		template<typename T>
+		static constexpr bool DeclaresUpdateBatch(...)
+		{
+			return false;
+		}
+	};
+}
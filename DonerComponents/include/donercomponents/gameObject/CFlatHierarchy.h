@@ -0,0 +1,109 @@
+////////////////////////////////////////////////////////////
+//
+// MIT License
+//
+// DonerComponents
+// Copyright(c) 2017 Donerkebap13
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+namespace DonerComponents
+{
+	class CGameObject;
+
+	// Game objects in depth first order, each one followed by its whole subtree. Reparenting
+	// moves the subtree block, so its cost depends on how far the block travels
+	class CFlatHierarchy
+	{
+	public:
+		static const std::size_t INVALID_POSITION = std::numeric_limits<std::size_t>::max();
+
+		// A walk over a subtree in progress. If the store moves nodes during the walk, the roots
+		// it still had to visit are saved in m_pendingRoots and m_changed is set. m_flatHierarchy
+		// is reset if the store is destroyed before the walk ends
+		struct SScan
+		{
+			SScan(std::size_t position, std::size_t end) : m_flatHierarchy(nullptr), m_position(position), m_end(end), m_changed(false) {}
+
+			CFlatHierarchy* m_flatHierarchy;
+			std::size_t m_position;
+			std::size_t m_end;
+			std::vector<CGameObject*> m_pendingRoots;
+			bool m_changed;
+		};
+
+		CFlatHierarchy() : m_numHoles(0) {}
+		~CFlatHierarchy();
+
+		CFlatHierarchy(const CFlatHierarchy&) = delete;
+		CFlatHierarchy& operator=(const CFlatHierarchy&) = delete;
+
+		// Appends gameObject and all its descendants as a new root
+		void AddSubtree(CGameObject* gameObject);
+		// Leaves a hole, skipped by the scans until Compact drops it
+		void Remove(CGameObject* gameObject);
+		// Moves the subtree of gameObject after the last descendant of parent, or to the end as a root
+		void SetParent(CGameObject* gameObject, CGameObject* parent);
+		// Drops the holes once they're a quarter of the store
+		void Compact();
+		void Clear();
+
+		bool Contains(const CGameObject* gameObject) const;
+		std::size_t GetSize() const { return m_nodes.size(); }
+		std::size_t GetNumHoles() const { return m_numHoles; }
+		// nullptr for holes
+		CGameObject* GetAt(std::size_t position) const { return m_nodes[position].m_gameObject; }
+		// Number of positions taken by the subtree starting at position, itself and holes included
+		std::size_t GetSubtreeSize(std::size_t position) const { return m_nodes[position].m_subtreeSize; }
+
+		// Scans nest, each BeginScan must be paired with an EndScan
+		void BeginScan(SScan& scan);
+		void EndScan() { m_scans.pop_back(); }
+
+	private:
+		struct SNode
+		{
+			SNode(CGameObject* gameObject) : m_gameObject(gameObject), m_parent(nullptr), m_subtreeSize(1) {}
+
+			CGameObject* m_gameObject;
+			CGameObject* m_parent;
+			std::size_t m_subtreeSize;
+		};
+
+		void Add(CGameObject* gameObject);
+		void AddToAncestorsSize(CGameObject* parent, std::size_t size);
+		void RemoveFromAncestorsSize(CGameObject* parent, std::size_t size);
+		std::size_t MoveBlock(std::size_t position, std::size_t size, std::size_t target);
+		void UpdatePositions(std::size_t begin, std::size_t end);
+		void SaveScans();
+
+		std::vector<SNode> m_nodes;
+		std::vector<std::size_t> m_holesBefore;
+		std::size_t m_numHoles;
+		std::vector<SScan*> m_scans;
+	};
+}
@@ -31,13 +31,27 @@
 #include <donercomponents/ErrorMessages.h>
 #include <donercomponents/common/CFactory.h>
 #include <donercomponents/component/CComponent.h>
+#include <donercomponents/gameObject/CFlatHierarchy.h>
 #include <donercomponents/handle/CHandle.h>
-#include <donercomponents/messages/CPostMsg.h>
+#include <donercomponents/jobs/CCommandBuffer.h>
+#include <donercomponents/jobs/CJobSystem.h>
+#include <donercomponents/messages/CPostMsgQueue.h>
+#include <donercomponents/messages/CPostMsgTimingWheel.h>
 #include <donercomponents/utils/hash/CStrID.h>
+#include <donercomponents/utils/hash/CStrIDTable.h>
+#include <donercomponents/utils/hash/hash_cstrid.h>
 #include <donercomponents/tags/CTagsManager.h>
+#include <donercomponents/utils/CAtomicBitMask.h>
 
+#include <atomic>
+#include <deque>
 #include <vector>
 #include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
 
 namespace DonerComponents
 {
@@ -47,6 +61,10 @@ namespace DonerComponents
 	class CGameObject : public CFactoryElement
 	{
 		template<class CGameObject> friend class CFactory;
+		friend class CFlatHierarchy;
+		friend class CGameObjectManager;
+		friend class CPrefabManager;
+		friend class CCommandBuffer;
 	public:
 		operator CHandle();
 		const CGameObject* operator=(const CHandle& rhs);
@@ -108,10 +126,19 @@ namespace DonerComponents
 		void SetParent(CGameObject* newParent);
 		CHandle GetParent() const { return m_parent; }
 		bool AddChild(CHandle newChild);
+		// Moves all of them under this game object in one go, removing them from their current parents.
+		// Returns how many were added, skipping invalid handles, this game object and current children
+		std::size_t AddChildren(const std::vector<CHandle>& newChildren);
 		bool RemoveChild(CHandle child);
 		bool HasChild(CHandle child) const;
-		int GetChildrenCount() const { return m_children.size(); }
+		int GetChildrenCount() const { return static_cast<int>(m_children.size() - m_numRemovedChildren); }
+		// Compares name hashes. While CStrIDTable is enabled, a hit is checked against the child's
+		// name text, and a different name with the same hash returns no child
 		CHandle GetChildByName(const std::string& name);
+		template<unsigned Len>
+		CHandle GetChildByName(const char(&name)[Len]) { return GetChildByName(CStrID(name)); }
+		// Game objects with many children look it up in a name index instead of comparing each child
+		CHandle GetChildByName(CStrID nameId);
 		CHandle GetChildByIndex(std::size_t index);
 
 		CHandle AddComponent(CStrID nameId);
@@ -156,17 +183,14 @@ namespace DonerComponents
 		std::vector<CHandle> GetChildrenWithTagsRecursive(Args... args)
 		{
 			std::vector<CHandle> children;
-			for (CGameObject* child : m_children)
+			VisitSubtree([&](CGameObject* gameObject)
 			{
-				if (child)
+				if (gameObject != this && gameObject->HasTags(args...))
 				{
-					if (child->HasTags(std::forward<Args>(args)...))
-					{
-						children.emplace_back(child);
-					}
-					child->GetChildrenWithTagsRecursiveInternal(children, std::forward<Args>(args)...);
+					children.emplace_back(gameObject);
 				}
-			}
+				return true;
+			});
 			return children;
 		}
 		template<typename... Args>
@@ -186,24 +210,28 @@ namespace DonerComponents
 		std::vector<CHandle> GetChildrenWithAnyTagRecursive(Args... args)
 		{
 			std::vector<CHandle> children;
-			for (CGameObject* child : m_children)
+			VisitSubtree([&](CGameObject* gameObject)
 			{
-				if (child)
+				if (gameObject != this && gameObject->HasAnyTag(args...))
 				{
-					if (child->HasAnyTag(std::forward<Args>(args)...))
-					{
-						children.emplace_back(child);
-					}
-					child->GetChildrenWithAnyTagRecursiveInternal(children, std::forward<Args>(args)...);
+					children.emplace_back(gameObject);
 				}
-			}
+				return true;
+			});
 			return children;
 		}
 
 		template<typename T>
 		void SendMessage(const T& message, ESendMessageType type = ESendMessageType::NonRecursive)
 		{
-			if (IsActive() && !IsDestroyed())
+			if (type == ESendMessageType::Recursive)
+			{
+				std::vector<CGameObject*>& stack = GetTraversalStack();
+				std::size_t stackBase = stack.size();
+				stack.emplace_back(this);
+				SendMessageToSubtrees(message, stackBase);
+			}
+			else if (IsActive() && !IsDestroyed())
 			{
 				for (CComponent* component : m_components)
 				{
@@ -212,16 +240,18 @@ namespace DonerComponents
 						component->SendMessage(message);
 					}
 				}
+			}
+		}
 
-				if (type == ESendMessageType::Recursive)
+		// Sends getMessage(0) to getMessage(count - 1) to each component before moving to the next one
+		template<typename T, typename TGetMessage>
+		void SendMessages(std::size_t count, TGetMessage getMessage)
+		{
+			for (CComponent* component : m_components)
+			{
+				if (component && IsActive() && !IsDestroyed())
 				{
-					for (CGameObject* child : m_children)
-					{
-						if (child)
-						{
-							child->SendMessage(message, type);
-						}
-					}
+					component->SendMessages<T>(count, getMessage);
 				}
 			}
 		}
@@ -231,21 +261,31 @@ namespace DonerComponents
 		{
 			if (IsActive() && !IsDestroyed())
 			{
-				for (CGameObject* child : m_children)
+				if (type == ESendMessageType::Recursive)
 				{
-					if (child)
+					std::vector<CGameObject*>& stack = GetTraversalStack();
+					std::size_t stackBase = stack.size();
+					PushChildren(stack);
+					SendMessageToSubtrees(message, stackBase);
+				}
+				else
+				{
+					for (CGameObject* child : m_children)
 					{
-						child->SendMessage(message, type);
+						if (child)
+						{
+							child->SendMessage(message);
+						}
 					}
 				}
 			}
 		}
 
 		template<typename T>
-		void PostMessage(const T& message, ESendMessageType type = ESendMessageType::NonRecursive);
+		void PostMessage(const T& message, ESendMessageType type = ESendMessageType::NonRecursive, EPostMsgPriority priority = EPostMsgPriority::Normal);
 
 		template<typename T>
-		void PostMessageToChildren(const T& message, ESendMessageType type = ESendMessageType::NonRecursive);
+		void PostMessageToChildren(const T& message, ESendMessageType type = ESendMessageType::NonRecursive, EPostMsgPriority priority = EPostMsgPriority::Normal);
 
 		void Init();
 		void Destroy();
@@ -254,11 +294,16 @@ namespace DonerComponents
 		void Deactivate();
 
 		bool IsInitialized() const { return m_initialized; }
-		bool IsActive() const { return m_numDeactivations == 0; }
+		// Takes into account the Activate and Deactivate calls still waiting for their callbacks
+		bool IsActive() const;
 		bool IsDestroyed() const { return m_destroyed; }
 
-		void SetName(const std::string& name) { m_name = name; }
-		const std::string& GetName() const { return m_name; }
+		// Names given as text are registered in CStrIDTable, to be read back while debugging
+		void SetName(const std::string& name) { SetName(CStrIDTable::Register(name.c_str())); }
+		template<unsigned Len>
+		void SetName(const char(&name)[Len]) { SetName(CStrIDTable::Register(name)); }
+		void SetName(CStrID name);
+		CStrID GetName() const { return m_name; }
 
 		bool GetIsInitiallyActive() const { return m_initiallyActive; }
 		void SetIsInitiallyActive(bool initiallyActive) { m_initiallyActive = initiallyActive; }
@@ -267,49 +312,74 @@ namespace DonerComponents
 		void CloneFrom(CGameObject* gameObject);
 
 	private:
+		static const std::size_t CHILDREN_BY_NAME_MIN_CHILDREN = 16;
+
 		CGameObject();
 		~CGameObject();
 
 		void DestroyInternal();
+		bool RemoveComponentInternal(CComponent* component);
+		// Keeps the prefab template and its descendants out of the name lookups
+		void MarkAsPrefab();
 
+		// These return the number of game objects visited
+		std::size_t ActivateNow();
+		std::size_t DeactivateNow();
 		void ActivateFromParent();
-		void ActivateInternal();
+		std::size_t ActivateInternal();
 		void CheckFirstActivationInternal();
 
-		template<typename... Args>
-		void GetChildrenWithTagsRecursiveInternal(std::vector<CHandle>& children, Args... args)
+		// Depth first, visiting the descendants of a game object only if visit returns true for it.
+		// Scans the flat hierarchy when enabled, and goes on through m_children if visit reparents
+		// or creates game objects
+		template<typename TVisitor>
+		void VisitSubtree(TVisitor visit);
+		// Visits the game objects above stackBase in the traversal stack and their descendants
+		template<typename TVisitor>
+		void VisitStack(std::size_t stackBase, TVisitor& visit);
+
+		// Depth first, in the same order a recursive traversal would follow. Handlers sending
+		// recursive messages of their own use the stack above stackBase and leave it as they found it
+		template<typename T>
+		void SendMessageToSubtrees(const T& message, std::size_t stackBase)
 		{
-			for (CGameObject* child : m_children)
+			std::vector<CGameObject*>& stack = GetTraversalStack();
+			while (stack.size() > stackBase)
 			{
-				if (child)
+				CGameObject* gameObject = stack.back();
+				stack.pop_back();
+				if (gameObject->IsActive() && !gameObject->IsDestroyed())
 				{
-					if (child->HasTags(std::forward<Args>(args)...))
+					for (CComponent* component : gameObject->m_components)
 					{
-						children.emplace_back(child);
+						if (component)
+						{
+							component->SendMessage(message);
+						}
 					}
-					child->GetChildrenWithTagsRecursiveInternal(children, std::forward<Args>(args)...);
+					gameObject->PushChildren(stack);
 				}
 			}
 		}
 
-		template<typename... Args>
-		void GetChildrenWithAnyTagRecursiveInternal(std::vector<CHandle>& children, Args... args)
-		{
-			for (CGameObject* child : m_children)
-			{
-				if (child)
-				{
-					if (child->HasAnyTag(std::forward<Args>(args)...))
-					{
-						children.emplace_back(child);
-					}
-					child->GetChildrenWithAnyTagRecursiveInternal(children, std::forward<Args>(args)...);
-				}
-			}
-		}
+		CGameObject* Resolve(const CHandle& handle) const;
+		// Position of child in m_children, or m_children.size() if it isn't a child of this
+		std::size_t GetChildIndex(const CHandle& child) const;
+		void RemoveChildAt(std::size_t index);
+		// Drops the invalid handles left by RemoveChild, so children get consecutive indices again
+		void CompactChildren();
+
+		// Scratch stack reused by the recursive traversals of the calling thread
+		static std::vector<CGameObject*>& GetTraversalStack();
+		// Pushes the valid children in reverse order, so they're popped in order
+		void PushChildren(std::vector<CGameObject*>& stack);
 
 		CHandle m_parent;
+		// Removed children leave an invalid handle behind, so the rest keep their index
 		std::vector<CHandle> m_children;
+		std::size_t m_numRemovedChildren;
+		// Index of this game object in its parent's m_children
+		std::size_t m_childIndex;
 
 		std::vector<CComponent*> m_components;
 
@@ -319,12 +389,24 @@ namespace DonerComponents
 
 		TagsMask m_tags;
 
-		std::string m_name;
+		CStrID m_name;
+		// First child with each name. Rebuilt on the next lookup after a child is removed or renamed
+		std::unordered_map<CStrID, CHandle> m_childrenByName;
+		bool m_childrenByNameValid;
+
+		std::size_t m_flatPosition;
+		// Position in its bucket of CGameObjectManager's name index
+		std::size_t m_nameIndexPosition;
 
+		// Sequences of the first and last Activate or Deactivate queued on this game object. The
+		// calls queued on the same game object are linked through SPendingActivation::m_next
+		std::size_t m_firstPendingActivation;
+		std::size_t m_lastPendingActivation;
 		int m_numDeactivations;
 		bool m_initialized;
 		bool m_destroyed;
 		bool m_initiallyActive;
+		bool m_prefab;
 	};
 
 	// -------------------------
@@ -335,49 +417,308 @@ namespace DonerComponents
 	{
 		friend class CDonerComponentsSystems;
 		friend class CGameObject;
+		friend class CCommandBuffer;
 	public:
+		static constexpr float DELAYED_POST_MSG_RESOLUTION = 1.f / 60.f;
+
 		~CGameObjectManager() override {}
 
+		// Only visits the components whose type registered a handler for T,
+		// by component type registration order and then by pool order
 		template<typename T>
 		void BroadcastMessage(const T& message)
 		{
-			for (SEntry& entry : m_entries)
+			SBroadcastCursor cursor(CTypeHasher::Index<T>());
+			while (CComponent* component = GetNextBroadcastTarget(cursor))
 			{
-				if (entry.m_used)
-				{
-					entry.m_data->SendMessage(message);
-				}
+				component->SendMessage(message);
 			}
 		}
 
 		template<typename T>
-		void PostMessage(CHandle gameObject, const T& message)
+		void PostMessage(CHandle gameObject, const T& message, EPostMsgPriority priority = EPostMsgPriority::Normal)
 		{
-			m_postMsgs.emplace_back(new CPostMessage<T>(gameObject, message));
+			CCommandBuffer* commandBuffer = CCommandBuffer::GetCurrent();
+			if (commandBuffer)
+			{
+				commandBuffer->PostMessage(gameObject, message, priority);
+			}
+			else if (SThreadPostMsgs* threadPostMsgs = GetJobThreadPostMsgs())
+			{
+				SJobPostMsgs& jobPostMsgs = threadPostMsgs->BeginWrite(priority);
+				jobPostMsgs.m_postMsgs.Push(gameObject, message);
+				threadPostMsgs->EndWrite(jobPostMsgs);
+			}
+			else if (std::this_thread::get_id() == m_mainThreadId)
+			{
+				GetPostMsgQueue(priority).Push(gameObject, message);
+			}
+			else
+			{
+				std::lock_guard<std::mutex> lock(m_otherThreadPostMsgs.m_mutex);
+				m_otherThreadPostMsgs.m_postMsgs[static_cast<std::size_t>(priority)].Push(gameObject, message);
+			}
 		}
 
 		CGameObject* CreateGameObject();
 
+		// Posts message once delay seconds have passed, rounded up to DELAYED_POST_MSG_RESOLUTION.
+		// Must be called from the main thread
+		template<typename T>
+		void PostMessageDelayed(CHandle gameObject, const T& message, float delay)
+		{
+			m_delayedPostMsgs.Push(gameObject, message, delay);
+		}
+		void UpdateDelayedPostMsgs(float dt);
+		std::size_t GetDelayedPostMsgsCount() const { return m_delayedPostMsgs.GetSize(); }
 
 		void SendPostMsgs();
+		// Max post messages sent per SendPostMsgs, 0 for no limit. High and normal priority messages
+		// are always sent, low priority ones wait for the next frames once the budget is spent
+		void SetPostMsgBudget(std::size_t maxPostMsgs) { m_postMsgBudget = maxPostMsgs; }
+		std::size_t GetPostMsgBudget() const { return m_postMsgBudget; }
+		// Low priority messages carried over to the next SendPostMsgs
+		std::size_t GetCarriedPostMsgsCount() const;
+		// Batched delivery groups post messages by type and game object. Each component then
+		// receives all the messages of a group before the next component receives any of them
+		void SetPostMsgDelivery(EPostMsgDelivery delivery) { m_postMsgDelivery = delivery; }
+		EPostMsgDelivery GetPostMsgDelivery() const { return m_postMsgDelivery; }
+		// Destroyed game objects are freed here, in pool order
 		void ExecuteScheduledDestroys();
 
+		// Keeps every hierarchy in a depth first ordered array, so Init, Destroy, Activate, Deactivate
+		// and the recursive tag queries scan memory linearly instead of hopping from child to child
+		void SetFlatHierarchyEnabled(bool enabled);
+		bool IsFlatHierarchyEnabled() const { return m_flatHierarchy != nullptr; }
+		const CFlatHierarchy* GetFlatHierarchy() const { return m_flatHierarchy.get(); }
+
+		static const std::size_t INVALID_PENDING_ACTIVATION = std::numeric_limits<std::size_t>::max();
+
+		// Activate and Deactivate only get queued, and the components receive their callbacks in a batch
+		// from ExecutePendingActivations. CGameObject::IsActive already returns the state they lead to
+		void SetDeferredActivationEnabled(bool enabled);
+		bool IsDeferredActivationEnabled() const { return m_deferredActivation; }
+		// Applies the queued calls in order until they've visited maxGameObjects game objects, 0 for no
+		// limit. A call is never split, the rest wait for the next execution
+		void ExecutePendingActivations(std::size_t maxGameObjects = 0);
+		std::size_t GetPendingActivationsCount() const { return m_pendingActivations.size() - m_pendingActivationsBegin; }
+		// Max game objects visited by the queued calls in each CDonerComponentsSystems::Update, 0 for no limit
+		void SetActivationBudget(std::size_t maxGameObjects) { m_activationBudget = maxGameObjects; }
+		std::size_t GetActivationBudget() const { return m_activationBudget; }
+
+		// Index from name to the game objects with that name, updated by SetName and Destroy.
+		// Without it the lookups below scan every game object. Main thread only
+		void SetNameIndexEnabled(bool enabled);
+		bool IsNameIndexEnabled() const { return m_nameIndexEnabled; }
+		// A game object with this name, prefab templates excluded. Which one is unspecified when several share it
+		CHandle GetGameObjectByName(CStrID name);
+		std::vector<CHandle> GetGameObjectsByName(CStrID name);
+
 	private:
-		CGameObjectManager();
+		struct SBroadcastCursor
+		{
+			SBroadcastCursor(CTypeHasher::TypeIndex messageIdx) : m_messageIdx(messageIdx), m_subscriber(0), m_position(0) {}
 
-		bool DestroyGameObject(CHandle handle);
-		void ScheduleDestroy(CHandle handle);
+			CTypeHasher::TypeIndex m_messageIdx;
+			std::size_t m_subscriber;
+			std::size_t m_position;
+		};
+
+		struct SPendingActivation
+		{
+			SPendingActivation(CHandle handle, bool activate) : m_handle(handle), m_next(INVALID_PENDING_ACTIVATION), m_activate(activate) {}
+
+			CHandle m_handle;
+			// Sequence of the next call queued on the same game object
+			std::size_t m_next;
+			bool m_activate;
+		};
+
+		struct SNamedGameObject
+		{
+			SNamedGameObject(CGameObject* gameObject, CHandle handle) : m_gameObject(gameObject), m_handle(handle) {}
+
+			CGameObject* m_gameObject;
+			CHandle m_handle;
+		};
+
+		// Consecutive messages posted by the same job
+		struct SPostMsgRun
+		{
+			CJobSystem::TJobKey m_key;
+			const CJobSystem::SJobContext* m_context;
+			// Job sequence of the first message and of the one after the last
+			std::size_t m_sequence;
+			std::size_t m_nextSequence;
+			std::size_t m_begin;
+			std::size_t m_end;
+		};
+
+		struct SJobPostMsgs
+		{
+			CPostMsgQueue m_postMsgs;
+			// Kept between frames so copying their keys doesn't allocate, only the first m_numRuns are in use
+			std::vector<SPostMsgRun> m_runs;
+			std::size_t m_numRuns;
+		};
+
+		// Messages posted from jobs running on a job system worker, or on the main thread for the last one.
+		// Only that thread writes them, to one buffer while SendPostMsgs reads the other
+		struct SThreadPostMsgs
+		{
+			SThreadPostMsgs();
 
-		std::vector<CPostMessageBase*> m_postMsgs;
-		std::vector<CHandle> m_scheduledDestroys;
+			SJobPostMsgs& BeginWrite(EPostMsgPriority priority);
+			void EndWrite(SJobPostMsgs& jobPostMsgs);
+			// Called from the main thread. Returns the buffer written until now, once the thread is done with it
+			std::size_t SwapBuffers();
+
+			SJobPostMsgs m_buffers[2][static_cast<std::size_t>(EPostMsgPriority::Count)];
+			std::atomic<std::size_t> m_writeBuffer;
+			// 1 + the buffer being written, or 0
+			std::atomic<std::size_t> m_writingBuffer;
+		};
+
+		// Messages posted from threads outside the job system
+		struct SOtherThreadPostMsgs
+		{
+			std::mutex m_mutex;
+			CPostMsgQueue m_postMsgs[static_cast<std::size_t>(EPostMsgPriority::Count)];
+		};
+
+		struct SPostMsgRunRef
+		{
+			const SPostMsgRun* m_run;
+			CPostMsgQueue* m_postMsgs;
+		};
+
+		CGameObjectManager();
+
+		CComponent* GetNextBroadcastTarget(SBroadcastCursor& cursor) const;
+		// Messages of the job running on the calling thread, or nullptr if it's not a job on a worker or the main thread
+		SThreadPostMsgs* GetJobThreadPostMsgs();
+		void MergeJobPostMsgs();
+		static const std::size_t INVALID_NAME_INDEX_POSITION = std::numeric_limits<std::size_t>::max();
+
+		void AddToNameIndex(CGameObject* gameObject);
+		void QueueActivation(CGameObject* gameObject, bool activate);
+		SPendingActivation& GetPendingActivation(std::size_t sequence) { return m_pendingActivations[sequence - m_pendingActivationsBase]; }
+		const SPendingActivation& GetPendingActivation(std::size_t sequence) const { return m_pendingActivations[sequence - m_pendingActivationsBase]; }
+		bool IsActiveAfterPendingActivations(const CGameObject* gameObject) const;
+		void RemoveFromNameIndex(CGameObject* gameObject);
+		// Messages posted while the other queues are being sent
+		CPostMsgQueue& GetPostMsgQueue(EPostMsgPriority priority) { return m_postMsgQueues[m_currentPostMsgQueue][static_cast<std::size_t>(priority)]; }
+		void SendPostMsgs(CPostMsgQueue& postMsgs);
+		void SendLowPriorityPostMsgs(CPostMsgQueue& postMsgs, std::size_t maxPostMsgs);
+		void DestroyGameObjectAt(std::size_t position);
+		void ScheduleDestroy(CGameObject* gameObject);
+
+		CPostMsgQueue m_postMsgQueues[2][static_cast<std::size_t>(EPostMsgPriority::Count)];
+		std::size_t m_currentPostMsgQueue;
+		EPostMsgDelivery m_postMsgDelivery;
+		std::size_t m_postMsgBudget;
+		// Low priority messages over budget, oldest first. Emptied queues are kept for reuse
+		std::deque<std::unique_ptr<CPostMsgQueue>> m_carriedPostMsgs;
+		std::vector<std::unique_ptr<CPostMsgQueue>> m_freePostMsgQueues;
+		std::vector<std::unique_ptr<SThreadPostMsgs>> m_threadPostMsgs;
+		std::vector<std::size_t> m_threadReadBuffers;
+		std::vector<SPostMsgRunRef> m_postMsgRunRefs;
+		SOtherThreadPostMsgs m_otherThreadPostMsgs;
+		std::thread::id m_mainThreadId;
+		CPostMsgTimingWheel m_delayedPostMsgs;
+		// One bit per pool position
+		CAtomicBitMask m_scheduledDestroyMask;
+		std::size_t m_numScheduledDestroys;
+		std::unique_ptr<CFlatHierarchy> m_flatHierarchy;
+		std::unordered_map<CStrID, std::vector<SNamedGameObject>> m_gameObjectsByName;
+		bool m_nameIndexEnabled;
+		// Applied ones before m_pendingActivationsBegin are dropped once they're half of the vector.
+		// m_pendingActivationsBase is the sequence of the first element
+		std::vector<SPendingActivation> m_pendingActivations;
+		std::size_t m_pendingActivationsBegin;
+		std::size_t m_pendingActivationsBase;
+		std::size_t m_activationBudget;
+		bool m_deferredActivation;
 	};
 
+	inline bool CGameObject::IsActive() const
+	{
+		if (m_gameObjectManager.GetPendingActivationsCount() == 0)
+		{
+			return m_numDeactivations == 0;
+		}
+		return m_gameObjectManager.IsActiveAfterPendingActivations(this);
+	}
+
+	template<typename TVisitor>
+	void CGameObject::VisitSubtree(TVisitor visit)
+	{
+		CFlatHierarchy* flatHierarchy = m_gameObjectManager.m_flatHierarchy.get();
+		if (flatHierarchy && m_flatPosition < flatHierarchy->GetSize())
+		{
+			CFlatHierarchy::SScan scan(m_flatPosition, m_flatPosition + flatHierarchy->GetSubtreeSize(m_flatPosition));
+			flatHierarchy->BeginScan(scan);
+			while (scan.m_position < scan.m_end)
+			{
+				CGameObject* gameObject = flatHierarchy->GetAt(scan.m_position);
+				if (!gameObject)
+				{
+					++scan.m_position;
+					continue;
+				}
+
+				bool visitChildren = visit(gameObject);
+				if (scan.m_changed)
+				{
+					// visit moved nodes of the store, so the rest of the walk follows m_children instead
+					if (scan.m_flatHierarchy)
+					{
+						scan.m_flatHierarchy->EndScan();
+					}
+					std::vector<CGameObject*>& stack = GetTraversalStack();
+					std::size_t stackBase = stack.size();
+					stack.insert(stack.end(), scan.m_pendingRoots.rbegin(), scan.m_pendingRoots.rend());
+					if (visitChildren)
+					{
+						gameObject->PushChildren(stack);
+					}
+					VisitStack(stackBase, visit);
+					return;
+				}
+				scan.m_position += visitChildren ? 1 : flatHierarchy->GetSubtreeSize(scan.m_position);
+			}
+			flatHierarchy->EndScan();
+		}
+		else
+		{
+			std::vector<CGameObject*>& stack = GetTraversalStack();
+			std::size_t stackBase = stack.size();
+			stack.emplace_back(this);
+			VisitStack(stackBase, visit);
+		}
+	}
+
+	template<typename TVisitor>
+	void CGameObject::VisitStack(std::size_t stackBase, TVisitor& visit)
+	{
+		std::vector<CGameObject*>& stack = GetTraversalStack();
+		while (stack.size() > stackBase)
+		{
+			CGameObject* gameObject = stack.back();
+			stack.pop_back();
+			if (visit(gameObject))
+			{
+				gameObject->PushChildren(stack);
+			}
+		}
+	}
+
 	template<typename T>
-	void CGameObject::PostMessage(const T& message, ESendMessageType type/* = ESendMessageType::NonRecursive*/)
+	void CGameObject::PostMessage(const T& message, ESendMessageType type/* = ESendMessageType::NonRecursive*/, EPostMsgPriority priority/* = EPostMsgPriority::Normal*/)
 	{
 		if (IsActive() && !IsDestroyed())
 		{
-			m_gameObjectManager.PostMessage(this, message);
+			m_gameObjectManager.PostMessage(this, message, priority);
 
 			if (type == ESendMessageType::Recursive)
 			{
@@ -385,7 +726,7 @@ namespace DonerComponents
 				{
 					if (child)
 					{
-						child->PostMessage(message, type);
+						child->PostMessage(message, type, priority);
 					}
 				}
 			}
@@ -393,7 +734,7 @@ namespace DonerComponents
 	}
 
 	template<typename T>
-	void CGameObject::PostMessageToChildren(const T& message, ESendMessageType type/* = ESendMessageType::NonRecursive*/)
+	void CGameObject::PostMessageToChildren(const T& message, ESendMessageType type/* = ESendMessageType::NonRecursive*/, EPostMsgPriority priority/* = EPostMsgPriority::Normal*/)
 	{
 		if (IsActive() && !IsDestroyed())
 		{
@@ -401,12 +742,29 @@ namespace DonerComponents
 			{
 				if (child)
 				{
-					child->PostMessage(message, type);
+					child->PostMessage(message, type, priority);
 				}
 			}
 		}
 	}
 
+	// -------------------------
+	// -- CPostMessage
+	// -------------------------
+
+	template<typename T>
+	void CPostMessage<T>::SendBatch(CPostMessageBase* const* postMsgs, std::size_t count)
+	{
+		CGameObject* gameObject = m_gameObject;
+		if (gameObject)
+		{
+			gameObject->SendMessages<T>(count, [postMsgs](std::size_t i) -> const T&
+			{
+				return static_cast<CPostMessage<T>*>(postMsgs[i])->m_messageData;
+			});
+		}
+	}
+
 	// -------------------------
 	// -- CHandle
 	// -------------------------
@@ -446,27 +804,27 @@ namespace DonerComponents
 	}
 
 	template<typename T>
-	void CHandle::PostMessage(const T& message, ESendMessageType type/* = ESendMessageType::NonRecursive*/)
+	void CHandle::PostMessage(const T& message, ESendMessageType type/* = ESendMessageType::NonRecursive*/, EPostMsgPriority priority/* = EPostMsgPriority::Normal*/)
 	{
 		if (m_elementType == CHandle::EElementType::GameObject)
 		{
 			CGameObject* gameObject = *this;
 			if (gameObject)
 			{
-				gameObject->PostMessage(message, type);
+				gameObject->PostMessage(message, type, priority);
 			}
 		}
 	}
 
 	template<typename T>
-	void CHandle::PostMessageToChildren(const T& message, ESendMessageType type/* = ESendMessageType::NonRecursive*/)
+	void CHandle::PostMessageToChildren(const T& message, ESendMessageType type/* = ESendMessageType::NonRecursive*/, EPostMsgPriority priority/* = EPostMsgPriority::Normal*/)
 	{
 		if (m_elementType == CHandle::EElementType::GameObject)
 		{
 			CGameObject* gameObject = *this;
 			if (gameObject)
 			{
-				gameObject->PostMessageToChildren(message, type);
+				gameObject->PostMessageToChildren(message, type, priority);
 			}
 		}
 	}
@@ -32,6 +32,8 @@
 
 #include <rapidjson/document.h>
 
+#include <functional>
+
 namespace DonerComponents
 {
 	class CGameObject;
@@ -47,7 +49,8 @@ namespace DonerComponents
 	{
 	public:
 		enum class EParsedGameObjectType { Scene, Prefab };
-		
+		using TParsedCallback = std::function<void(CHandle)>;
+
 		CGameObjectParser();
 
 		CHandle ParseSceneFromFile(const char* const path);
@@ -59,10 +62,20 @@ namespace DonerComponents
 		CHandle ParseSceneFromJson(const char* const jsonStr);
 		CHandle ParsePrefabFromJson(const char* const jsonStr);
 
+		// The file is loaded and parsed by the CJobSystem. GameObjects are created
+		// on the main thread during CDonerComponentsSystems::Update, calling callback afterwards
+		void ParseSceneFromFileAsync(const char* const path, TParsedCallback callback);
+		void ParsePrefabFromFileAsync(const char* const path, TParsedCallback callback);
+
 	private:
 		CHandle ParseFromFile(const char* const path, EParsedGameObjectType type);
 		CHandle ParseFromMemory(const unsigned char* jsonStringBuffer, std::size_t size, EParsedGameObjectType type);
 		CHandle ParseFromJson(const char* const jsonStr, EParsedGameObjectType type);
+		CHandle ParseFromDocument(const rapidjson::Document& document, EParsedGameObjectType type);
+		void ParseFromFileAsync(const char* const path, EParsedGameObjectType type, TParsedCallback callback);
+
+		static bool LoadDocument(const char* const path, rapidjson::Document& document);
+		static bool ParseDocument(const char* const jsonStr, rapidjson::Document& document);
 
 		CHandle ParseGameObject(const rapidjson::Value& gameObjectData, CGameObject* parent);
 		CHandle ParsePrefab(const rapidjson::Value& gameObjectData);
@@ -84,9 +84,9 @@ namespace DonerComponents
 		template<typename T>
 		void SendMessageToChildren(const T& message, ESendMessageType type = ESendMessageType::NonRecursive);
 		template<typename T>
-		void PostMessage(const T& message, ESendMessageType type = ESendMessageType::NonRecursive);
+		void PostMessage(const T& message, ESendMessageType type = ESendMessageType::NonRecursive, EPostMsgPriority priority = EPostMsgPriority::Normal);
 		template<typename T>
-		void PostMessageToChildren(const T& message, ESendMessageType type = ESendMessageType::NonRecursive);
+		void PostMessageToChildren(const T& message, ESendMessageType type = ESendMessageType::NonRecursive, EPostMsgPriority priority = EPostMsgPriority::Normal);
 
 		void Destroy();
 
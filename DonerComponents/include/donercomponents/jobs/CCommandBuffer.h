@@ -0,0 +1,79 @@
+////////////////////////////////////////////////////////////
+//
+// MIT License
+//
+// DonerComponents
+// Copyright(c) 2017 Donerkebap13
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <donercomponents/handle/CHandle.h>
+#include <donercomponents/messages/CPostMsgQueue.h>
+
+#include <vector>
+
+namespace DonerComponents
+{
+	// Records post messages, destroys and component removals issued from worker threads so they
+	// can be replayed on the main thread in a deterministic order
+	class CCommandBuffer
+	{
+	public:
+		class CScope
+		{
+		public:
+			explicit CScope(CCommandBuffer& commandBuffer);
+			~CScope();
+
+		private:
+			CCommandBuffer* m_previous;
+		};
+
+		CCommandBuffer();
+		CCommandBuffer(const CCommandBuffer&) = delete;
+		~CCommandBuffer();
+
+		static CCommandBuffer* GetCurrent() { return s_current; }
+
+		template<typename T>
+		void PostMessage(CHandle gameObject, const T& message, EPostMsgPriority priority = EPostMsgPriority::Normal)
+		{
+			m_postMsgs[static_cast<std::size_t>(priority)].Push(gameObject, message);
+		}
+		void Destroy(CHandle handle) { m_destroys.emplace_back(handle); }
+		// Destroys the component and releases it from its game object and its factory
+		void RemoveComponent(CHandle component) { m_componentRemovals.emplace_back(component); }
+
+		// Moves the commands recorded in other to the end of this buffer
+		void Append(CCommandBuffer& other);
+		void Execute();
+		void Clear();
+
+	private:
+		CPostMsgQueue m_postMsgs[static_cast<std::size_t>(EPostMsgPriority::Count)];
+		std::vector<CHandle> m_destroys;
+		std::vector<CHandle> m_componentRemovals;
+
+		static thread_local CCommandBuffer* s_current;
+	};
+}
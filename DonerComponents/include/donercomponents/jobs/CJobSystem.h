@@ -0,0 +1,130 @@
+////////////////////////////////////////////////////////////
+//
+// MIT License
+//
+// DonerComponents
+// Copyright(c) 2017 Donerkebap13
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace DonerComponents
+{
+	class CJobSystem
+	{
+	public:
+		using TJob = std::function<void()>;
+		using TParallelForJob = std::function<void(std::size_t)>;
+		// Jobs submitted outside of any job get consecutive keys. Jobs submitted from a job extend its key
+		// with their position among its submissions, so keys don't depend on which worker runs each job
+		using TJobKey = std::vector<std::uint64_t>;
+
+		struct SJobContext
+		{
+			SJobContext(TJobKey key) : m_key(std::move(key)), m_numSubmitted(0), m_sequence(0) {}
+
+			TJobKey m_key;
+			std::size_t m_numSubmitted;
+			// Free for the job's own use, e.g. to order what it produces
+			std::size_t m_sequence;
+		};
+
+		// Without workers, jobs are run inline when submitted
+		explicit CJobSystem(std::size_t numWorkers);
+		~CJobSystem();
+
+		void Submit(TJob job);
+		// continuation is submitted once job is done
+		void Submit(TJob job, TJob continuation);
+		// For jobs whose order is known up front, e.g. the tasks of a graph, so their keys
+		// don't depend on which job happens to submit them
+		void SubmitWithKey(TJob job, TJobKey key);
+		// Key the next job submitted from the calling thread would get
+		TJobKey GetNextJobKey();
+
+		// Jobs touching GameObjects, components or any other DonerComponents system
+		// must run on the main thread. They're executed during CDonerComponentsSystems::Update
+		void SubmitToMainThread(TJob job);
+		void ExecuteMainThreadJobs();
+
+		// Runs job(i) for every i in [0, count) and returns once all of them are done
+		void ParallelFor(std::size_t count, const TParallelForJob& job);
+
+		// Runs pending jobs on the calling thread until counter reaches 0
+		void Wait(const std::atomic<int>& counter);
+
+		std::size_t GetNumWorkers() const { return m_workers.size(); }
+		// Index of the worker running the calling thread, or GetNumWorkers() outside of the workers
+		std::size_t GetCurrentWorkerIdx() const { return GetCurrentQueueIdx(); }
+		// Context of the job running on the calling thread, or nullptr outside of jobs
+		static SJobContext* GetCurrentJobContext() { return s_currentJobContext; }
+
+	private:
+		struct SJob
+		{
+			TJob m_job;
+			TJobKey m_key;
+		};
+
+		// Each worker owns a queue, popping from the back and stealing from the front of others.
+		// The last queue receives the jobs submitted from non-worker threads.
+		struct SJobQueue
+		{
+			std::mutex m_mutex;
+			std::deque<SJob> m_jobs;
+		};
+
+		void WorkerLoop(std::size_t queueIdx);
+		bool RunPendingJob(std::size_t queueIdx);
+		bool PopJob(std::size_t queueIdx, SJob& job);
+		bool StealJob(std::size_t queueIdx, SJob& job);
+		static void RunJob(SJob& job);
+		std::size_t GetCurrentQueueIdx() const;
+
+		std::vector<std::thread> m_workers;
+		std::vector<std::unique_ptr<SJobQueue>> m_queues;
+
+		std::mutex m_mainThreadMutex;
+		std::vector<TJob> m_mainThreadJobs;
+
+		std::mutex m_sleepMutex;
+		std::condition_variable m_sleepCondition;
+		std::atomic<int> m_numPendingJobs;
+		std::atomic<std::uint64_t> m_nextJobKey;
+		bool m_running;
+
+		static thread_local CJobSystem* s_currentJobSystem;
+		static thread_local std::size_t s_currentQueueIdx;
+		static thread_local SJobContext* s_currentJobContext;
+	};
+}
@@ -0,0 +1,68 @@
+////////////////////////////////////////////////////////////
+//
+// MIT License
+//
+// DonerComponents
+// Copyright(c) 2017 Donerkebap13
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <donercomponents/jobs/CJobSystem.h>
+
+#include <atomic>
+#include <vector>
+
+namespace DonerComponents
+{
+	// Set of jobs with dependencies between them that can be run several times.
+	// Tasks can only depend on tasks added before them, so the graph is always acyclic
+	class CTaskGraph
+	{
+	public:
+		using TTaskId = std::size_t;
+
+		TTaskId AddTask(CJobSystem::TJob job);
+		// task won't start until dependency is done
+		bool AddDependency(TTaskId task, TTaskId dependency);
+
+		// Blocks until every task is done, running tasks on the calling thread meanwhile
+		void Run(CJobSystem& jobSystem);
+		void Clear();
+
+		std::size_t GetNumTasks() const { return m_tasks.size(); }
+
+	private:
+		struct STask
+		{
+			CJobSystem::TJob m_job;
+			std::vector<TTaskId> m_successors;
+			int m_numPredecessors;
+			STask(CJobSystem::TJob job) : m_job(std::move(job)), m_numPredecessors(0) {}
+		};
+
+		void SubmitTask(TTaskId task, CJobSystem& jobSystem, const CJobSystem::TJobKey& runKey, std::atomic<int>& remainingTasks);
+
+		std::vector<STask> m_tasks;
+		std::vector<std::atomic<int>> m_pendingPredecessors;
+	};
+}
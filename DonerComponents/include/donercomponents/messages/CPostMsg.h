@@ -28,23 +28,64 @@
 #pragma once
 
 #include <donercomponents/handle/CHandle.h>
+#include <donercomponents/utils/hash/CTypeHasher.h>
+
+#include <type_traits>
+#include <utility>
+
+// Must be used from the global namespace
+#define DONER_DECLARE_POST_MESSAGE_AS_COALESCED(message_name)                  \
+	namespace DonerComponents                                                  \
+	{                                                                          \
+		template<> struct SCoalescePostMsg<message_name> : std::true_type {};  \
+	}
 
 namespace DonerComponents
 {
+	class CPostMsgQueue;
+
+	// Post messages of the types declared as coalesced are merged through SPostMsgCoalescer
+	// with the one already pending for the same GameObject, instead of being queued again
+	template<typename T>
+	struct SCoalescePostMsg : std::false_type {};
+
+	// Keeps the pending message by default. Specialize it to combine both payloads
+	template<typename T>
+	struct SPostMsgCoalescer
+	{
+		static void Coalesce(T& /*pending*/, const T& /*incoming*/) {}
+	};
+
 	class CPostMessageBase
 	{
 	public:
+		CPostMessageBase(CHandle gameObject, CTypeHasher::TypeIndex messageIdx)
+			: m_gameObject(gameObject)
+			, m_messageIdx(messageIdx)
+		{}
 		virtual ~CPostMessageBase() {}
+
 		virtual void SendMessage() = 0;
+		// postMsgs must all have the type and game object of this message
+		virtual void SendBatch(CPostMessageBase* const* postMsgs, std::size_t count) = 0;
+		virtual void MoveTo(CPostMsgQueue& queue) = 0;
+
+		CHandle GetGameObject() const { return m_gameObject; }
+		CTypeHasher::TypeIndex GetMessageIndex() const { return m_messageIdx; }
+
+	protected:
+		CHandle m_gameObject;
+		CTypeHasher::TypeIndex m_messageIdx;
 	};
 
 	template<typename T>
 	class CPostMessage : public CPostMessageBase
 	{
 	public:
-		CPostMessage(CHandle gameObject, const T& messageData)
-			: m_gameObject(gameObject)
-			, m_messageData(messageData)
+		template<typename U>
+		CPostMessage(CHandle gameObject, U&& messageData)
+			: CPostMessageBase(gameObject, CTypeHasher::Index<T>())
+			, m_messageData(std::forward<U>(messageData))
 		{}
 
 		void SendMessage() override
@@ -55,8 +96,14 @@ namespace DonerComponents
 			}
 		}
 
+		T& GetMessageData() { return m_messageData; }
+
+		// Defined in CGameObject.h
+		void SendBatch(CPostMessageBase* const* postMsgs, std::size_t count) override;
+		// Defined in CPostMsgQueue.h
+		void MoveTo(CPostMsgQueue& queue) override;
+
 	private:
-		CHandle m_gameObject;
 		T m_messageData;
 	};
 }
@@ -0,0 +1,195 @@
+////////////////////////////////////////////////////////////
+//
+// MIT License
+//
+// DonerComponents
+// Copyright(c) 2017 Donerkebap13
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <donercomponents/messages/CPostMsg.h>
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace DonerComponents
+{
+	// Post messages constructed in place on memory blocks that are kept between frames,
+	// so posting doesn't allocate once the queue has grown to its usual size
+	class CPostMsgQueue
+	{
+	public:
+		static const std::size_t DEFAULT_BLOCK_SIZE = 16 * 1024;
+
+		explicit CPostMsgQueue(std::size_t blockSize = DEFAULT_BLOCK_SIZE);
+		~CPostMsgQueue();
+
+		CPostMsgQueue(const CPostMsgQueue&) = delete;
+		CPostMsgQueue& operator=(const CPostMsgQueue&) = delete;
+
+		template<typename T>
+		void Push(CHandle gameObject, T&& message)
+		{
+			typedef typename std::decay<T>::type TMessage;
+			if (m_coalescing)
+			{
+				Push(gameObject, std::forward<T>(message), SCoalescePostMsg<TMessage>());
+			}
+			else
+			{
+				Push(gameObject, std::forward<T>(message), std::false_type());
+			}
+		}
+
+		// Queues later merged into another one shouldn't coalesce, so messages are combined in merge order
+		void SetCoalescingEnabled(bool enabled) { m_coalescing = enabled; }
+
+		// Sends the messages in posting order and empties the queue
+		void SendAll();
+		// Sends up to maxMsgs messages in posting order, returning how many were sent.
+		// The memory is only reused once every message has been sent
+		std::size_t SendFront(std::size_t maxMsgs);
+		// Sends the messages grouped by message type and then by game object, so each
+		// group looks its handlers up once. Keeps the posting order inside each group
+		void SendAllBatched();
+		// Moves the messages to the end of other and empties this queue
+		void MoveTo(CPostMsgQueue& other);
+		// Moves the messages in [begin, end) to the end of other. Clear the queue once done moving
+		void MoveRangeTo(std::size_t begin, std::size_t end, CPostMsgQueue& other);
+		// Moves the message i to the end of getQueue(i) and empties this queue
+		template<typename TGetQueue>
+		void MoveEachTo(TGetQueue getQueue)
+		{
+			for (std::size_t i = m_head; i < m_postMsgs.size(); ++i)
+			{
+				m_postMsgs[i]->MoveTo(getQueue(i - m_head));
+			}
+			Clear();
+		}
+		void Clear();
+
+		bool IsEmpty() const { return m_head == m_postMsgs.size(); }
+		std::size_t GetSize() const { return m_postMsgs.size() - m_head; }
+
+	private:
+		struct SBlock
+		{
+			SBlock(std::size_t size) : m_data(new char[size]), m_size(size) {}
+
+			char* m_data;
+			std::size_t m_size;
+		};
+
+		struct SBatchEntry
+		{
+			bool operator<(const SBatchEntry& rhs) const
+			{
+				if (m_messageIdx != rhs.m_messageIdx)
+				{
+					return m_messageIdx < rhs.m_messageIdx;
+				}
+				if (m_gameObject != rhs.m_gameObject)
+				{
+					return m_gameObject < rhs.m_gameObject;
+				}
+				return m_order < rhs.m_order;
+			}
+
+			CPostMessageBase* m_postMsg;
+			CTypeHasher::TypeIndex m_messageIdx;
+			int m_gameObject;
+			std::size_t m_order;
+		};
+
+		struct SCoalescedSlot
+		{
+			SCoalescedSlot() : m_gameObject(0), m_messageIdx(0), m_position(0), m_generation(0) {}
+
+			int m_gameObject;
+			CTypeHasher::TypeIndex m_messageIdx;
+			std::size_t m_position;
+			std::size_t m_generation;
+		};
+
+		static const std::size_t NO_POSITION = static_cast<std::size_t>(-1);
+
+		template<typename T>
+		void Push(CHandle gameObject, T&& message, std::false_type /*coalesce*/)
+		{
+			typedef CPostMessage<typename std::decay<T>::type> TPostMessage;
+			void* memory = Allocate(sizeof(TPostMessage), alignof(TPostMessage));
+			m_postMsgs.emplace_back(new (memory) TPostMessage(gameObject, std::forward<T>(message)));
+		}
+
+		template<typename T>
+		void Push(CHandle gameObject, T&& message, std::true_type /*coalesce*/)
+		{
+			typedef typename std::decay<T>::type TMessage;
+			std::size_t& position = FindCoalescedPosition(GetGameObjectKey(gameObject), CTypeHasher::Index<TMessage>());
+			if (position != NO_POSITION)
+			{
+				CPostMessage<TMessage>* pending = static_cast<CPostMessage<TMessage>*>(m_postMsgs[position]);
+				SPostMsgCoalescer<TMessage>::Coalesce(pending->GetMessageData(), message);
+			}
+			else
+			{
+				position = m_postMsgs.size();
+				Push(gameObject, std::forward<T>(message), std::false_type());
+			}
+		}
+
+		// Through a const handle, otherwise it converts to int through operator bool
+		static int GetGameObjectKey(const CHandle& gameObject) { return static_cast<int>(gameObject); }
+
+		// Position of the pending message with the same key, or a reference to set it if there's none
+		std::size_t& FindCoalescedPosition(int gameObjectKey, CTypeHasher::TypeIndex messageIdx);
+		SCoalescedSlot& FindCoalescedSlot(int gameObjectKey, CTypeHasher::TypeIndex messageIdx);
+		void* Allocate(std::size_t size, std::size_t alignment);
+		void Reset();
+
+		std::vector<SBlock> m_blocks;
+		std::vector<CPostMessageBase*> m_postMsgs;
+		// Messages before m_head have already been sent
+		std::size_t m_head;
+		// Kept between frames so batched sends don't allocate
+		std::vector<SBatchEntry> m_batchEntries;
+		std::vector<CPostMessageBase*> m_batchMsgs;
+		// Open addressing table of the coalesced messages pending, slots from older generations are free
+		std::vector<SCoalescedSlot> m_coalescedSlots;
+		std::size_t m_numCoalesced;
+		std::size_t m_generation;
+		bool m_coalescing;
+		std::size_t m_blockSize;
+		std::size_t m_currentBlock;
+		std::size_t m_offset;
+	};
+
+	template<typename T>
+	void CPostMessage<T>::MoveTo(CPostMsgQueue& queue)
+	{
+		queue.Push(m_gameObject, std::move(m_messageData));
+	}
+}
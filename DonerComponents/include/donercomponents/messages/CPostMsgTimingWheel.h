@@ -0,0 +1,97 @@
+////////////////////////////////////////////////////////////
+//
+// MIT License
+//
+// DonerComponents
+// Copyright(c) 2017 Donerkebap13
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <donercomponents/messages/CPostMsgQueue.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace DonerComponents
+{
+	// Hierarchical timing wheel holding post messages until their delay expires.
+	// Advancing it costs the same no matter how many messages are waiting
+	class CPostMsgTimingWheel
+	{
+	public:
+		static const std::size_t NUM_LEVELS = 4;
+		static const std::size_t SLOT_BITS = 6;
+		static const std::size_t NUM_SLOTS = 1 << SLOT_BITS;
+		static const std::size_t SLOT_BLOCK_SIZE = 1024;
+		// Longer delays are clamped to this
+		static const std::uint64_t MAX_DELAY_TICKS = std::uint64_t(1) << 48;
+
+		explicit CPostMsgTimingWheel(float tickDuration);
+
+		CPostMsgTimingWheel(const CPostMsgTimingWheel&) = delete;
+		CPostMsgTimingWheel& operator=(const CPostMsgTimingWheel&) = delete;
+
+		// The delay is rounded up to whole ticks, waiting at least one. NaN or negative delays wait one tick
+		template<typename T>
+		void Push(CHandle gameObject, const T& message, float delay)
+		{
+			std::uint64_t dueTick = GetDueTick(delay);
+			SSlot& slot = GetSlot(dueTick);
+			slot.m_dueTicks.emplace_back(dueTick);
+			slot.m_postMsgs.Push(gameObject, message);
+			++m_size;
+		}
+
+		// Moves the messages whose delay has expired to the end of queue
+		void Advance(float dt, CPostMsgQueue& queue);
+		void Clear();
+
+		std::size_t GetSize() const { return m_size; }
+		float GetTickDuration() const { return m_tickDuration; }
+
+	private:
+		struct SSlot
+		{
+			SSlot() : m_postMsgs(SLOT_BLOCK_SIZE) {}
+
+			CPostMsgQueue m_postMsgs;
+			std::vector<std::uint64_t> m_dueTicks;
+		};
+
+		std::uint64_t GetDueTick(float delay) const;
+		SSlot& GetSlot(std::uint64_t dueTick);
+		void Tick(CPostMsgQueue& queue);
+		void Cascade(SSlot& slot);
+
+		SSlot m_slots[NUM_LEVELS][NUM_SLOTS];
+		// Messages due too far for the top level, placed again each time the top level wraps around.
+		// The ones still too far go to the other slot
+		SSlot m_overflow[2];
+		std::size_t m_currentOverflow;
+		std::vector<std::uint64_t> m_cascadedDueTicks;
+		std::uint64_t m_currentTick;
+		double m_accumulatedTime;
+		float m_tickDuration;
+		std::size_t m_size;
+	};
+}
@@ -0,0 +1,58 @@
+////////////////////////////////////////////////////////////
+//
+// MIT License
+//
+// DonerComponents
+// Copyright(c) 2017 Donerkebap13
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace DonerComponents
+{
+	// Fixed size bit mask whose bits can be set and cleared concurrently from different threads
+	class CAtomicBitMask
+	{
+	public:
+		CAtomicBitMask();
+
+		// Clears every bit
+		void Resize(std::size_t size);
+		void Set(std::size_t position, bool value);
+		bool Get(std::size_t position) const;
+
+		// First set bit in [begin, end), or end if there's none
+		std::size_t GetNextSet(std::size_t begin, std::size_t end) const;
+		std::size_t GetNextSet(std::size_t begin) const { return GetNextSet(begin, m_size); }
+
+		std::size_t GetSize() const { return m_size; }
+
+	private:
+		std::vector<std::atomic<std::uint64_t>> m_words;
+		std::size_t m_size;
+	};
+}
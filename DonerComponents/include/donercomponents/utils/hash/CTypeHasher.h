@@ -28,6 +28,15 @@
 #pragma once
 
 #include <donercomponents/Defines.h>
+#include <donercomponents/utils/hash/elbeno_constexpr_murmur3.h>
+
+#include <cstddef>
+
+#if defined(_MSC_VER)
+	#define DC_TYPE_SIGNATURE __FUNCSIG__
+#else
+	#define DC_TYPE_SIGNATURE __PRETTY_FUNCTION__
+#endif
 
 namespace DonerComponents
 {
@@ -36,13 +45,30 @@ namespace DonerComponents
 	public:
 		CTypeHasher() = delete;
 
-		using HashId = intptr_t;
+		using HashId = unsigned;
+		using TypeIndex = std::size_t;
+
+		// Computed at compile time from the type name, so it's the same
+		// for every build and shared library using the same compiler
+		template<typename T>
+		static constexpr HashId Hash()
+		{
+			return cx::murmur3_32(DC_TYPE_SIGNATURE);
+		}
 
+		// Sequential index assigned the first time each type is requested, meant to index arrays directly.
+		// Indices are handed out by the library by full type name, so they also agree across shared libraries
 		template<typename T>
-		static HashId Hash()
+		static TypeIndex Index()
 		{
-			static int dummy = 0;
-			return reinterpret_cast<HashId>(&dummy);
+			static const TypeIndex index = GetIndex(DC_TYPE_SIGNATURE, &index);
+			return index;
 		}
+
+		static TypeIndex GetNumIndices();
+
+	private:
+		// localTag tells apart types with the same name in anonymous namespaces of different translation units
+		static TypeIndex GetIndex(const char* signature, const void* localTag);
 	};
 }
@@ -30,6 +30,7 @@
 #include <donercomponents/component/CComponentFactoryManager.h>
 #include <donercomponents/gameObject/CGameObject.h>
 #include <donercomponents/gameObject/CPrefabManager.h>
+#include <donercomponents/jobs/CJobSystem.h>
 #include <donercomponents/tags/CTagsManager.h>
 
 #include <cassert>
@@ -41,6 +42,7 @@ namespace DonerComponents
 		, m_gameObjectManager(nullptr)
 		, m_tagsManager(nullptr)
 		, m_prefabManager(nullptr)
+		, m_jobSystem(nullptr)
 		, m_initialized(false)
 	{
 	}
@@ -50,11 +52,13 @@ namespace DonerComponents
 		Destroy();
 	}
 
-	CDonerComponentsSystems& CDonerComponentsSystems::Init()
+	CDonerComponentsSystems& CDonerComponentsSystems::Init(std::size_t numWorkerThreads/* = 0*/)
 	{
 		assert(!m_initialized);
 		m_initialized = true;
 
+		m_jobSystem = new CJobSystem(numWorkerThreads);
+
 		m_componentFactoryManager = new CComponentFactoryManager();
 		m_gameObjectManager = new CGameObjectManager();
 		m_tagsManager = new CTagsManager();
@@ -73,6 +77,7 @@ namespace DonerComponents
 		m_componentFactoryManager->ExecuteScheduledDestroys();
 		m_gameObjectManager->ExecuteScheduledDestroys();
 
+		DC_DELETE_POINTER(m_jobSystem);
 		DC_DELETE_POINTER(m_gameObjectManager);
 		DC_DELETE_POINTER(m_componentFactoryManager);
 
@@ -81,6 +86,12 @@ namespace DonerComponents
 
 	void CDonerComponentsSystems::Update(float dt)
 	{
+		// Runs the jobs waiting for the main thread
+		m_jobSystem->ExecuteMainThreadJobs();
+
+		// Delivers the activation callbacks deferred since the last update, within the activation budget
+		m_gameObjectManager->ExecutePendingActivations(m_gameObjectManager->GetActivationBudget());
+
 		// Updates all registered components
 		m_componentFactoryManager->Update(dt);
 
@@ -88,7 +99,8 @@ namespace DonerComponents
 		m_componentFactoryManager->ExecuteScheduledDestroys();
 		m_gameObjectManager->ExecuteScheduledDestroys();
 
-		// Sends postMsg
+		// Sends postMsg, including the delayed ones whose time has come
+		m_gameObjectManager->UpdateDelayedPostMsgs(dt);
 		m_gameObjectManager->SendPostMsgs();
 	}
 
@@ -114,4 +126,10 @@ namespace DonerComponents
 		assert(m_initialized);
 		return m_prefabManager;
 	}
+
+	CJobSystem* CDonerComponentsSystems::GetJobSystem()
+	{
+		assert(m_initialized);
+		return m_jobSystem;
+	}
 }
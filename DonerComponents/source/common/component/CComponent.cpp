@@ -27,26 +27,25 @@
 
 #include <donercomponents/CDonerComponentsSystems.h>
 #include <donercomponents/component/CComponent.h>
+#include <donercomponents/component/CComponentFactory.h>
 #include <donercomponents/component/CComponentFactoryManager.h>
 #include <donercomponents/gameObject/CGameObject.h>
+#include <donercomponents/jobs/CCommandBuffer.h>
 
 namespace DonerComponents
 {
 	CComponent::CComponent()
-		: m_numDeactivations(1)
+		: m_factory(nullptr)
+		, m_messageTable(nullptr)
+		, m_numDeactivations(1)
 		, m_initialized(false)
 		, m_destroyed(false)
 		, m_initiallyActive(true)
+		, m_sleeping(false)
 	{}
 
 	CComponent::~CComponent()
-	{
-		for (auto& pair : m_messages)
-		{
-			delete pair.second;
-		}
-		m_messages.clear();
-	}
+	{}
 
 	CComponent::operator CHandle()
 	{
@@ -77,7 +76,14 @@ namespace DonerComponents
 	{
 		if (!m_initialized)
 		{
-			RegisterMessages();
+			if (!m_messageTable || !m_messageTable->IsBuilt())
+			{
+				RegisterMessages();
+				if (m_messageTable)
+				{
+					m_messageTable->SetBuilt();
+				}
+			}
 			DoInit();
 			m_initialized = true;
 		}
@@ -93,6 +99,13 @@ namespace DonerComponents
 
 	void CComponent::Destroy()
 	{
+		CCommandBuffer* commandBuffer = CCommandBuffer::GetCurrent();
+		if (commandBuffer)
+		{
+			commandBuffer->Destroy(this);
+			return;
+		}
+
 		if (!m_destroyed)
 		{
 			if (m_initialized)
@@ -104,6 +117,50 @@ namespace DonerComponents
 		}
 	}
 
+	void CComponent::RegisterMessageHandler(CTypeHasher::TypeIndex messageIdx, CMsgHandlerBase* handler)
+	{
+		if (!m_messageTable)
+		{
+			delete handler;
+			DC_WARNING_MSG(EErrorCode::ComponentNotRegisteredInFactory, "Only components created by a factory can register messages");
+			return;
+		}
+
+		if (m_messageTable->Add(messageIdx, handler))
+		{
+			CDonerComponentsSystems::Get()->GetComponentFactoryManager()->AddMessageSubscriber(messageIdx, m_factory);
+		}
+		else
+		{
+			delete handler;
+			DC_WARNING_MSG(EErrorCode::MessageAlreadyRegistered, "The message is already registered for this component");
+		}
+	}
+
+	void CComponent::Sleep()
+	{
+		if (!m_sleeping)
+		{
+			m_sleeping = true;
+			if (m_factory)
+			{
+				m_factory->SetComponentAwake(this, false);
+			}
+		}
+	}
+
+	void CComponent::WakeUp()
+	{
+		if (m_sleeping)
+		{
+			m_sleeping = false;
+			if (m_factory)
+			{
+				m_factory->SetComponentAwake(this, true);
+			}
+		}
+	}
+
 	void CComponent::Activate()
 	{
 		if (m_initialized)
@@ -25,14 +25,36 @@
 //
 ////////////////////////////////////////////////////////////
 
+#include <donercomponents/CDonerComponentsSystems.h>
 #include <donercomponents/component/CComponent.h>
 #include <donercomponents/component/CComponentFactory.h>
 #include <donercomponents/handle/CHandle.h>
+#include <donercomponents/jobs/CCommandBuffer.h>
+#include <donercomponents/jobs/CJobSystem.h>
 
 #include <algorithm>
 
 namespace DonerComponents
 {
+	IComponentFactory::IComponentFactory()
+		: m_numScheduledDestroys(0)
+		, m_parallelDestroys(false)
+		, m_updateChunkSize(0)
+		, m_budgetMaxComponents(0)
+		, m_budgetMaxTime(0)
+		, m_budgetCursor(0)
+		, m_budgetTime(0.0)
+	{}
+
+	IComponentFactory::~IComponentFactory()
+	{
+		for (CCommandBuffer* commandBuffer : m_chunkCommandBuffers)
+		{
+			delete commandBuffer;
+		}
+		m_chunkCommandBuffers.clear();
+	}
+
 	bool IComponentFactory::SetHandleInfoFromComponent(CComponent* component, CHandle& handle)
 	{
 		int pos = GetComponentPosition(component);
@@ -46,23 +68,157 @@ namespace DonerComponents
 		return false;
 	}
 
-	void IComponentFactory::ScheduleDestroyComponent(CHandle component)
+	void IComponentFactory::ScheduleDestroyComponent(CComponent* component)
 	{
-		if (std::find(m_scheduledDestroys.begin(), m_scheduledDestroys.end(), component) == m_scheduledDestroys.end())
+		int position = GetComponentPosition(component);
+		if (position != -1 && !m_scheduledDestroyMask.Get(position))
 		{
-			m_scheduledDestroys.emplace_back(component);
+			m_scheduledDestroyMask.Set(position, true);
+			++m_numScheduledDestroys;
 		}
 	}
 
 	void IComponentFactory::ExecuteScheduledDestroys()
 	{
-		for (CComponent* component : m_scheduledDestroys)
+		std::size_t position = m_scheduledDestroyMask.GetNextSet(0);
+		while (m_numScheduledDestroys > 0 && position < GetCapacity())
+		{
+			DestroyComponent(GetComponentAt(position));
+			UnscheduleDestroy(position);
+			position = m_scheduledDestroyMask.GetNextSet(position + 1);
+		}
+	}
+
+	void IComponentFactory::UnscheduleDestroy(std::size_t position)
+	{
+		if (m_scheduledDestroyMask.Get(position))
+		{
+			m_scheduledDestroyMask.Set(position, false);
+			--m_numScheduledDestroys;
+		}
+	}
+
+	void IComponentFactory::SetUpdateBudget(std::size_t maxComponents, std::chrono::microseconds maxTime)
+	{
+		m_budgetMaxComponents = maxComponents;
+		m_budgetMaxTime = maxTime;
+		m_lastUpdateTimes.clear();
+	}
+
+	void IComponentFactory::InitMasks(std::size_t numElements)
+	{
+		m_liveMask.Resize(numElements);
+		m_awakeMask.Resize(numElements);
+		m_scheduledDestroyMask.Resize(numElements);
+	}
+
+	void IComponentFactory::SetAwake(std::size_t position, bool awake)
+	{
+		m_awakeMask.Set(position, awake);
+		// Time spent dead or sleeping doesn't count for the next budgeted update
+		if (awake && position < m_lastUpdateTimes.size())
+		{
+			m_lastUpdateTimes[position] = m_budgetTime;
+		}
+	}
+
+	void IComponentFactory::UpdateWithBudget(std::size_t numElements, float dt)
+	{
+		if (m_lastUpdateTimes.size() != numElements)
+		{
+			m_lastUpdateTimes.assign(numElements, m_budgetTime);
+		}
+		m_budgetTime += dt;
+
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		std::size_t startPosition = m_budgetCursor < numElements ? m_budgetCursor : 0;
+		std::size_t position = startPosition;
+		std::size_t numUpdated = 0;
+		bool wrapped = false;
+		while (true)
+		{
+			position = GetNextAwake(position, numElements);
+			if (position == numElements)
+			{
+				if (wrapped)
+				{
+					break;
+				}
+				wrapped = true;
+				position = 0;
+				continue;
+			}
+			// Every awake component has already been updated during this Update
+			if (wrapped && position >= startPosition)
+			{
+				break;
+			}
+
+			float componentDt = static_cast<float>(m_budgetTime - m_lastUpdateTimes[position]);
+			m_lastUpdateTimes[position] = m_budgetTime;
+			UpdateComponentAt(position, componentDt);
+			++position;
+			++numUpdated;
+
+			if (m_budgetMaxComponents > 0 && numUpdated >= m_budgetMaxComponents)
+			{
+				break;
+			}
+			if (m_budgetMaxTime.count() > 0 && std::chrono::steady_clock::now() - start >= m_budgetMaxTime)
+			{
+				break;
+			}
+		}
+		m_budgetCursor = position;
+	}
+
+	void IComponentFactory::UpdateInChunks(std::size_t numElements, float dt)
+	{
+		CJobSystem* jobSystem = CDonerComponentsSystems::Get()->GetJobSystem();
+		if (jobSystem->GetNumWorkers() == 0 || numElements <= m_updateChunkSize)
 		{
-			if (component)
+			UpdateRange(0, numElements, dt);
+			return;
+		}
+
+		// Each chunk starts at an awake component, so the gaps of sparse pools don't become empty jobs
+		m_chunkBegins.clear();
+		for (std::size_t begin = GetNextAwake(0, numElements); begin < numElements; begin = GetNextAwake(std::min(begin + m_updateChunkSize, numElements), numElements))
+		{
+			m_chunkBegins.emplace_back(begin);
+		}
+		std::size_t numChunks = m_chunkBegins.size();
+		if (numChunks <= 1)
+		{
+			UpdateRange(numChunks > 0 ? m_chunkBegins[0] : numElements, numElements, dt);
+			return;
+		}
+
+		while (m_chunkCommandBuffers.size() < numChunks)
+		{
+			m_chunkCommandBuffers.emplace_back(new CCommandBuffer());
+		}
+
+		jobSystem->ParallelFor(numChunks, [this, numElements, dt](std::size_t chunkIdx)
+		{
+			std::size_t begin = m_chunkBegins[chunkIdx];
+			std::size_t end = std::min(begin + m_updateChunkSize, numElements);
+			CCommandBuffer::CScope scope(*m_chunkCommandBuffers[chunkIdx]);
+			UpdateRange(begin, end, dt);
+		});
+
+		// Merges the deferred work in chunk order, so results don't depend on which worker ran each chunk
+		CCommandBuffer* parentCommandBuffer = CCommandBuffer::GetCurrent();
+		for (std::size_t i = 0; i < numChunks; ++i)
+		{
+			if (parentCommandBuffer)
+			{
+				parentCommandBuffer->Append(*m_chunkCommandBuffers[i]);
+			}
+			else
 			{
-				DestroyComponent(component);
+				m_chunkCommandBuffers[i]->Execute();
 			}
 		}
-		m_scheduledDestroys.clear();
 	}
 }
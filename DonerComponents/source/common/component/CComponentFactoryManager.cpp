@@ -25,14 +25,32 @@
 //
 ////////////////////////////////////////////////////////////
 
+#include <donercomponents/CDonerComponentsSystems.h>
 #include <donercomponents/component/CComponent.h>
 #include <donercomponents/component/CComponentFactoryManager.h>
 #include <donercomponents/handle/CHandle.h>
+#include <donercomponents/jobs/CCommandBuffer.h>
+#include <donercomponents/jobs/CJobSystem.h>
 
 #include <cassert>
+#include <cmath>
 
 namespace DonerComponents
 {
+	CComponentFactoryManager::CComponentFactoryManager()
+		: m_updateDt(0.f)
+		, m_updateGraphDirty(false)
+	{}
+
+	CComponentFactoryManager::~CComponentFactoryManager()
+	{
+		for (CCommandBuffer* commandBuffer : m_commandBuffers)
+		{
+			delete commandBuffer;
+		}
+		m_commandBuffers.clear();
+	}
+
 	CComponent* CComponentFactoryManager::CreateComponent(CStrID componentNameId)
 	{
 		IComponentFactory* factory = GetFactoryByName(componentNameId);
@@ -129,6 +147,15 @@ namespace DonerComponents
 
 	bool CComponentFactoryManager::DestroyComponent(CComponent** component)
 	{
+		// Inside a parallel phase the whole removal waits for the main thread, so DoDestroy runs
+		// before the pool slot is released and the owner's slot isn't written from a worker
+		CCommandBuffer* commandBuffer = CCommandBuffer::GetCurrent();
+		if (commandBuffer)
+		{
+			commandBuffer->RemoveComponent(*component);
+			return true;
+		}
+
 		for (std::size_t i = 0; i < m_factories.size(); ++i)
 		{
 			if (m_factories[i].m_address->GetComponentPosition(*component) != -1)
@@ -183,9 +210,121 @@ namespace DonerComponents
 
 	void CComponentFactoryManager::Update(float dt)
 	{
-		for (SFactoryData& data : m_factories)
+		if (m_updateGraphDirty)
 		{
-			data.m_address->Update(dt);
+			BuildUpdatePhases();
+		}
+
+		CJobSystem* jobSystem = CDonerComponentsSystems::Get()->GetJobSystem();
+		for (SUpdatePhaseData& phaseData : m_phases)
+		{
+			if (phaseData.m_fixedDt > 0.f)
+			{
+				phaseData.m_accumulatedDt += dt;
+				int steps = 0;
+				while (phaseData.m_accumulatedDt >= phaseData.m_fixedDt && steps < phaseData.m_maxFixedSteps)
+				{
+					UpdatePhase(phaseData, phaseData.m_fixedDt, *jobSystem);
+					phaseData.m_accumulatedDt -= phaseData.m_fixedDt;
+					++steps;
+				}
+				// Drops the steps we couldn't afford so we don't fall further behind every frame
+				phaseData.m_accumulatedDt = std::fmod(phaseData.m_accumulatedDt, phaseData.m_fixedDt);
+			}
+			else
+			{
+				UpdatePhase(phaseData, dt, *jobSystem);
+			}
+		}
+	}
+
+	void CComponentFactoryManager::SetFixedTimestep(EUpdatePhase phase, float fixedDt, int maxSteps)
+	{
+		if (phase != EUpdatePhase::Count)
+		{
+			SUpdatePhaseData& phaseData = m_phases[static_cast<int>(phase)];
+			phaseData.m_fixedDt = fixedDt;
+			phaseData.m_maxFixedSteps = maxSteps;
+			phaseData.m_accumulatedDt = 0.f;
+		}
+	}
+
+	float CComponentFactoryManager::GetFixedTimestepAlpha(EUpdatePhase phase) const
+	{
+		if (phase != EUpdatePhase::Count)
+		{
+			const SUpdatePhaseData& phaseData = m_phases[static_cast<int>(phase)];
+			if (phaseData.m_fixedDt > 0.f)
+			{
+				return phaseData.m_accumulatedDt / phaseData.m_fixedDt;
+			}
+		}
+		return 0.f;
+	}
+
+	void CComponentFactoryManager::BuildUpdatePhases()
+	{
+		while (m_commandBuffers.size() < m_factories.size())
+		{
+			m_commandBuffers.emplace_back(new CCommandBuffer());
+		}
+
+		for (SUpdatePhaseData& phaseData : m_phases)
+		{
+			phaseData.m_factories.clear();
+			phaseData.m_updateGraph.Clear();
+		}
+
+		// Factories without declared dependencies conflict with everything,
+		// so they keep running in registration order within their phase
+		for (std::size_t i = 0; i < m_factories.size(); ++i)
+		{
+			// Component types not overriding DoUpdate are left out of the update entirely
+			if (!m_factories[i].m_address->IsUpdatable())
+			{
+				continue;
+			}
+
+			SUpdatePhaseData& phaseData = m_phases[static_cast<int>(m_factories[i].m_phase)];
+			CTaskGraph::TTaskId task = phaseData.m_updateGraph.AddTask([this, i]()
+			{
+				CCommandBuffer::CScope scope(*m_commandBuffers[i]);
+				m_factories[i].m_address->Update(m_updateDt);
+			});
+			for (CTaskGraph::TTaskId j = 0; j < task; ++j)
+			{
+				const SFactoryData& other = m_factories[phaseData.m_factories[j]];
+				bool conflicts = !m_factories[i].m_hasDependencies || !other.m_hasDependencies ||
+					m_factories[i].m_dependencies.ConflictsWith(other.m_dependencies);
+				if (conflicts)
+				{
+					phaseData.m_updateGraph.AddDependency(task, j);
+				}
+			}
+			phaseData.m_factories.emplace_back(i);
+		}
+		m_updateGraphDirty = false;
+	}
+
+	void CComponentFactoryManager::UpdatePhase(SUpdatePhaseData& phaseData, float dt, CJobSystem& jobSystem)
+	{
+		if (jobSystem.GetNumWorkers() > 0 && phaseData.m_factories.size() > 1)
+		{
+			m_updateDt = dt;
+			phaseData.m_updateGraph.Run(jobSystem);
+
+			// Replays deferred work in registration order to keep results deterministic
+			for (std::size_t factoryIdx : phaseData.m_factories)
+			{
+				m_commandBuffers[factoryIdx]->Execute();
+			}
+		}
+		else
+		{
+			for (std::size_t factoryIdx : phaseData.m_factories)
+			{
+				m_factories[factoryIdx].m_address->Update(dt);
+			}
 		}
 	}
 
@@ -202,11 +341,62 @@ namespace DonerComponents
 		DC_ERROR_MSG(EErrorCode::ComponentNotRegisteredInFactory, "Trying to destroy component created outside a factory");
 	}
 
+	void CComponentFactoryManager::AddMessageSubscriber(CTypeHasher::TypeIndex messageIdx, IComponentFactory* factory)
+	{
+		if (messageIdx >= m_messageSubscribers.size())
+		{
+			m_messageSubscribers.resize(messageIdx + 1);
+		}
+
+		// Kept sorted by factory registration order so broadcasts don't depend on which component was initialized first
+		auto factoryPosition = [this](IComponentFactory* factory)
+		{
+			for (std::size_t i = 0; i < m_factories.size(); ++i)
+			{
+				if (m_factories[i].m_address == factory)
+				{
+					return i;
+				}
+			}
+			return m_factories.size();
+		};
+		std::vector<IComponentFactory*>& subscribers = m_messageSubscribers[messageIdx];
+		std::size_t position = factoryPosition(factory);
+		auto it = subscribers.begin();
+		while (it != subscribers.end() && factoryPosition(*it) < position)
+		{
+			++it;
+		}
+		subscribers.insert(it, factory);
+	}
+
 	void CComponentFactoryManager::ExecuteScheduledDestroys()
 	{
+		// Destructors are user code, so only factories that opted in are destroyed in parallel
+		std::vector<IComponentFactory*> parallelFactories;
+		for (SFactoryData& data : m_factories)
+		{
+			if (data.m_address->HasScheduledDestroys() && data.m_address->IsParallelDestroysEnabled())
+			{
+				parallelFactories.emplace_back(data.m_address);
+			}
+		}
+
+		CJobSystem* jobSystem = CDonerComponentsSystems::Get()->GetJobSystem();
+		if (jobSystem->GetNumWorkers() > 0 && parallelFactories.size() > 1)
+		{
+			jobSystem->ParallelFor(parallelFactories.size(), [&parallelFactories](std::size_t factoryIdx)
+			{
+				parallelFactories[factoryIdx]->ExecuteScheduledDestroys();
+			});
+		}
+
 		for (SFactoryData& data : m_factories)
 		{
-			data.m_address->ExecuteScheduledDestroys();
+			if (data.m_address->HasScheduledDestroys())
+			{
+				data.m_address->ExecuteScheduledDestroys();
+			}
 		}
 	}
 }
@@ -0,0 +1,247 @@
+////////////////////////////////////////////////////////////
+//
+// MIT License
+//
+// DonerComponents
+// Copyright(c) 2017 Donerkebap13
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+#include <donercomponents/gameObject/CFlatHierarchy.h>
+#include <donercomponents/gameObject/CGameObject.h>
+
+#include <algorithm>
+#include <utility>
+
+namespace DonerComponents
+{
+	CFlatHierarchy::~CFlatHierarchy()
+	{
+		SaveScans();
+		for (SScan* scan : m_scans)
+		{
+			scan->m_flatHierarchy = nullptr;
+		}
+	}
+
+	void CFlatHierarchy::AddSubtree(CGameObject* gameObject)
+	{
+		// Appending in depth first order keeps every parent's block at the end of the store,
+		// so attaching each child doesn't move anything
+		std::vector<std::pair<CGameObject*, CGameObject*>> pending(1, std::make_pair(gameObject, nullptr));
+		std::vector<CGameObject*> children;
+		while (!pending.empty())
+		{
+			CGameObject* current = pending.back().first;
+			CGameObject* parent = pending.back().second;
+			pending.pop_back();
+			Add(current);
+			if (parent)
+			{
+				SetParent(current, parent);
+			}
+
+			children.clear();
+			current->PushChildren(children);
+			for (CGameObject* child : children)
+			{
+				pending.emplace_back(child, current);
+			}
+		}
+	}
+
+	void CFlatHierarchy::Remove(CGameObject* gameObject)
+	{
+		std::size_t position = gameObject->m_flatPosition;
+		if (position < m_nodes.size())
+		{
+			m_nodes[position].m_gameObject = nullptr;
+			m_nodes[position].m_parent = nullptr;
+			gameObject->m_flatPosition = INVALID_POSITION;
+			++m_numHoles;
+		}
+	}
+
+	void CFlatHierarchy::SetParent(CGameObject* gameObject, CGameObject* parent)
+	{
+		if (!Contains(gameObject))
+		{
+			// Created with GetNewElement instead of CreateGameObject
+			AddSubtree(gameObject);
+		}
+
+		SaveScans();
+		std::size_t position = gameObject->m_flatPosition;
+		std::size_t size = m_nodes[position].m_subtreeSize;
+		std::size_t target = m_nodes.size();
+		if (parent)
+		{
+			std::size_t parentPosition = parent->m_flatPosition;
+			if (parentPosition >= m_nodes.size() || (parentPosition >= position && parentPosition < position + size))
+			{
+				return;
+			}
+			target = parentPosition + m_nodes[parentPosition].m_subtreeSize;
+		}
+
+		RemoveFromAncestorsSize(m_nodes[position].m_parent, size);
+		position = MoveBlock(position, size, target);
+		m_nodes[position].m_parent = parent;
+		AddToAncestorsSize(parent, size);
+	}
+
+	void CFlatHierarchy::Compact()
+	{
+		if (m_numHoles == 0 || m_numHoles * 4 < m_nodes.size())
+		{
+			return;
+		}
+
+		SaveScans();
+		m_holesBefore.resize(m_nodes.size() + 1);
+		std::size_t numHoles = 0;
+		for (std::size_t i = 0; i < m_nodes.size(); ++i)
+		{
+			m_holesBefore[i] = numHoles;
+			if (!m_nodes[i].m_gameObject)
+			{
+				++numHoles;
+			}
+		}
+		m_holesBefore[m_nodes.size()] = numHoles;
+
+		std::size_t last = 0;
+		for (std::size_t i = 0; i < m_nodes.size(); ++i)
+		{
+			SNode& node = m_nodes[i];
+			if (node.m_gameObject)
+			{
+				node.m_subtreeSize -= m_holesBefore[i + node.m_subtreeSize] - m_holesBefore[i];
+				node.m_gameObject->m_flatPosition = last;
+				m_nodes[last++] = node;
+			}
+		}
+		m_nodes.erase(m_nodes.begin() + last, m_nodes.end());
+		m_numHoles = 0;
+	}
+
+	void CFlatHierarchy::Clear()
+	{
+		SaveScans();
+		for (SNode& node : m_nodes)
+		{
+			if (node.m_gameObject)
+			{
+				node.m_gameObject->m_flatPosition = INVALID_POSITION;
+			}
+		}
+		m_nodes.clear();
+		m_numHoles = 0;
+	}
+
+	bool CFlatHierarchy::Contains(const CGameObject* gameObject) const
+	{
+		return gameObject->m_flatPosition < m_nodes.size() && m_nodes[gameObject->m_flatPosition].m_gameObject == gameObject;
+	}
+
+	void CFlatHierarchy::BeginScan(SScan& scan)
+	{
+		scan.m_flatHierarchy = this;
+		m_scans.emplace_back(&scan);
+	}
+
+	void CFlatHierarchy::Add(CGameObject* gameObject)
+	{
+		gameObject->m_flatPosition = m_nodes.size();
+		m_nodes.emplace_back(gameObject);
+	}
+
+	void CFlatHierarchy::AddToAncestorsSize(CGameObject* parent, std::size_t size)
+	{
+		for (CGameObject* ancestor = parent; ancestor; ancestor = m_nodes[ancestor->m_flatPosition].m_parent)
+		{
+			m_nodes[ancestor->m_flatPosition].m_subtreeSize += size;
+		}
+	}
+
+	void CFlatHierarchy::RemoveFromAncestorsSize(CGameObject* parent, std::size_t size)
+	{
+		for (CGameObject* ancestor = parent; ancestor; ancestor = m_nodes[ancestor->m_flatPosition].m_parent)
+		{
+			m_nodes[ancestor->m_flatPosition].m_subtreeSize -= size;
+		}
+	}
+
+	std::size_t CFlatHierarchy::MoveBlock(std::size_t position, std::size_t size, std::size_t target)
+	{
+		if (target > position + size)
+		{
+			std::rotate(m_nodes.begin() + position, m_nodes.begin() + position + size, m_nodes.begin() + target);
+			UpdatePositions(position, target);
+			return target - size;
+		}
+		if (target < position)
+		{
+			std::rotate(m_nodes.begin() + target, m_nodes.begin() + position, m_nodes.begin() + position + size);
+			UpdatePositions(target, position + size);
+			return target;
+		}
+		return position;
+	}
+
+	void CFlatHierarchy::UpdatePositions(std::size_t begin, std::size_t end)
+	{
+		for (std::size_t i = begin; i < end; ++i)
+		{
+			if (m_nodes[i].m_gameObject)
+			{
+				m_nodes[i].m_gameObject->m_flatPosition = i;
+			}
+		}
+	}
+
+	void CFlatHierarchy::SaveScans()
+	{
+		for (SScan* scan : m_scans)
+		{
+			if (scan->m_changed)
+			{
+				continue;
+			}
+
+			scan->m_changed = true;
+			std::size_t position = scan->m_position + m_nodes[scan->m_position].m_subtreeSize;
+			while (position < scan->m_end)
+			{
+				const SNode& node = m_nodes[position];
+				if (node.m_gameObject)
+				{
+					scan->m_pendingRoots.emplace_back(node.m_gameObject);
+					position += node.m_subtreeSize;
+				}
+				else
+				{
+					++position;
+				}
+			}
+		}
+	}
+}
@@ -28,21 +28,31 @@
 #include <donercomponents/CDonerComponentsSystems.h>
 #include <donercomponents/gameObject/CGameObject.h>
 #include <donercomponents/component/CComponentFactoryManager.h>
+#include <donercomponents/jobs/CJobSystem.h>
 #include <donercomponents/tags/CTagsManager.h>
 
 #include <algorithm>
+#include <limits>
 #include <cassert>
 
 namespace DonerComponents
 {
 	CGameObject::CGameObject()
-		: m_componentFactoryManager(*CDonerComponentsSystems::Get()->GetComponentFactoryManager())
+		: m_numRemovedChildren(0)
+		, m_childIndex(0)
+		, m_componentFactoryManager(*CDonerComponentsSystems::Get()->GetComponentFactoryManager())
 		, m_gameObjectManager(*CDonerComponentsSystems::Get()->GetGameObjectManager())
 		, m_tagsManager(*CDonerComponentsSystems::Get()->GetTagsManager())
+		, m_childrenByNameValid(false)
+		, m_flatPosition(CFlatHierarchy::INVALID_POSITION)
+		, m_nameIndexPosition(CGameObjectManager::INVALID_NAME_INDEX_POSITION)
+		, m_firstPendingActivation(CGameObjectManager::INVALID_PENDING_ACTIVATION)
+		, m_lastPendingActivation(CGameObjectManager::INVALID_PENDING_ACTIVATION)
 		, m_numDeactivations(1)
 		, m_initialized(false)
 		, m_destroyed(false)
 		, m_initiallyActive(true)
+		, m_prefab(false)
 	{
 		m_components.resize(m_componentFactoryManager.GetRegisteredComponentsAmount());
 	}
@@ -72,6 +82,85 @@ namespace DonerComponents
 		return nullptr;
 	}
 
+	std::vector<CGameObject*>& CGameObject::GetTraversalStack()
+	{
+		static thread_local std::vector<CGameObject*> s_traversalStack;
+		return s_traversalStack;
+	}
+
+	void CGameObject::PushChildren(std::vector<CGameObject*>& stack)
+	{
+		// Resolved straight from the manager, instead of going through the singleton for each handle
+		for (auto it = m_children.rbegin(); it != m_children.rend(); ++it)
+		{
+			CGameObject* child = Resolve(*it);
+			if (child)
+			{
+				stack.emplace_back(child);
+			}
+		}
+	}
+
+	CGameObject* CGameObject::Resolve(const CHandle& handle) const
+	{
+		if (handle.m_elementType == CHandle::EElementType::GameObject)
+		{
+			return m_gameObjectManager.GetElementByIdxAndVersion(handle.m_elementPosition, handle.m_version);
+		}
+		return nullptr;
+	}
+
+	std::size_t CGameObject::GetChildIndex(const CHandle& child) const
+	{
+		CGameObject* gameObject = Resolve(child);
+		if (gameObject)
+		{
+			std::size_t index = gameObject->m_childIndex;
+			if (index < m_children.size() && m_children[index] == child)
+			{
+				return index;
+			}
+		}
+		else if (child.m_elementType == CHandle::EElementType::GameObject)
+		{
+			// Children destroyed without being removed can only be found by their stale handle
+			return std::find(m_children.begin(), m_children.end(), child) - m_children.begin();
+		}
+		return m_children.size();
+	}
+
+	void CGameObject::CompactChildren()
+	{
+		std::size_t last = 0;
+		for (std::size_t i = 0; i < m_children.size(); ++i)
+		{
+			if (m_children[i].m_elementType != CHandle::EElementType::None)
+			{
+				CGameObject* child = Resolve(m_children[i]);
+				if (child)
+				{
+					child->m_childIndex = last;
+				}
+				m_children[last++] = m_children[i];
+			}
+		}
+		m_children.resize(last);
+		m_numRemovedChildren = 0;
+	}
+
+	void CGameObject::SetName(CStrID name)
+	{
+		m_gameObjectManager.RemoveFromNameIndex(this);
+		m_name = name;
+		m_gameObjectManager.AddToNameIndex(this);
+
+		CGameObject* parent = m_parent;
+		if (parent)
+		{
+			parent->m_childrenByNameValid = false;
+		}
+	}
+
 	void CGameObject::SetParent(CGameObject* newParent)
 	{
 		CGameObject* oldParent = m_parent;
@@ -84,11 +173,26 @@ namespace DonerComponents
 
 	bool CGameObject::AddChild(CHandle newChild)
 	{
-		if (newChild && !HasChild(newChild))
+		CGameObject* gameObject = Resolve(newChild);
+		if (gameObject && !HasChild(newChild))
 		{
-			CGameObject* gameObject = newChild;
-			gameObject->SetParent(this);
+			// The old parent drops it without moving it in the flat hierarchy, so it's only moved once below
+			CGameObject* oldParent = Resolve(gameObject->m_parent);
+			if (oldParent)
+			{
+				oldParent->RemoveChildAt(oldParent->GetChildIndex(newChild));
+			}
+			gameObject->m_parent = this;
+			gameObject->m_childIndex = m_children.size();
 			m_children.emplace_back(newChild);
+			if (m_childrenByNameValid)
+			{
+				m_childrenByName.emplace(gameObject->m_name, newChild);
+			}
+			if (m_gameObjectManager.m_flatHierarchy)
+			{
+				m_gameObjectManager.m_flatHierarchy->SetParent(gameObject, this);
+			}
 			return true;
 		}
 		DC_WARNING_MSG(EErrorCode::GameObjectChildAlreadyExists, "Child already added to this gameObject");
@@ -97,40 +201,149 @@ namespace DonerComponents
 
 	bool CGameObject::RemoveChild(CHandle child)
 	{
-		std::vector<CHandle>::iterator it = std::find(m_children.begin(), m_children.end(), child);
-		if (it != m_children.end())
+		std::size_t index = GetChildIndex(child);
+		if (index < m_children.size())
 		{
-			CGameObject* gameObject = (*it);
-			m_children.erase(it);
-			if (gameObject->GetParent() == *this)
+			RemoveChildAt(index);
+
+			CGameObject* gameObject = Resolve(child);
+			if (gameObject)
 			{
-				gameObject->SetParent(nullptr);
+				if (m_gameObjectManager.m_flatHierarchy)
+				{
+					m_gameObjectManager.m_flatHierarchy->SetParent(gameObject, nullptr);
+				}
+				if (Resolve(gameObject->m_parent) == this)
+				{
+					gameObject->SetParent(nullptr);
+				}
 			}
 			return true;
 		}
 		return false;
 	}
 
+	std::size_t CGameObject::AddChildren(const std::vector<CHandle>& newChildren)
+	{
+		CHandle handle = *this;
+		CFlatHierarchy* flatHierarchy = m_gameObjectManager.m_flatHierarchy.get();
+		m_children.reserve(m_children.size() + newChildren.size());
+
+		std::size_t numAdded = 0;
+		for (const CHandle& newChild : newChildren)
+		{
+			CGameObject* gameObject = Resolve(newChild);
+			if (!gameObject || gameObject == this || HasChild(newChild))
+			{
+				continue;
+			}
+
+			// As in AddChild, the old parent drops it without moving it in the flat hierarchy
+			CGameObject* oldParent = Resolve(gameObject->m_parent);
+			if (oldParent)
+			{
+				oldParent->RemoveChildAt(oldParent->GetChildIndex(newChild));
+			}
+			gameObject->m_parent = handle;
+			gameObject->m_childIndex = m_children.size();
+			m_children.emplace_back(newChild);
+
+			if (m_childrenByNameValid)
+			{
+				m_childrenByName.emplace(gameObject->m_name, newChild);
+			}
+			if (flatHierarchy)
+			{
+				flatHierarchy->SetParent(gameObject, this);
+			}
+			++numAdded;
+		}
+
+		if (numAdded < newChildren.size())
+		{
+			DC_WARNING_MSG(EErrorCode::GameObjectChildAlreadyExists, "%u gameObjects couldn't be added as children", static_cast<unsigned>(newChildren.size() - numAdded));
+		}
+		return numAdded;
+	}
+
+	void CGameObject::RemoveChildAt(std::size_t index)
+	{
+		if (index < m_children.size())
+		{
+			m_children[index] = CHandle();
+			++m_numRemovedChildren;
+			m_childrenByNameValid = false;
+			if (m_numRemovedChildren * 2 > m_children.size())
+			{
+				CompactChildren();
+			}
+		}
+	}
+
 	bool CGameObject::HasChild(CHandle child) const
 	{
-		return std::find(m_children.begin(), m_children.end(), child) != m_children.end();
+		return GetChildIndex(child) < m_children.size();
 	}
 
 	CHandle CGameObject::GetChildByName(const std::string& name)
 	{
-		for (CGameObject* child : m_children)
+		CHandle child = GetChildByName(CStrID(name.c_str()));
+		if (child && CStrIDTable::IsEnabled())
 		{
-			if (child && child->GetName() == name)
+			CGameObject* gameObject = child;
+			const char* childName = CStrIDTable::GetString(gameObject->m_name);
+			if (*childName && name != childName)
 			{
-				return child;
+				DC_ERROR_MSG(EErrorCode::NameHashCollision, "Child name %s has the same hash as %s", childName, name.c_str());
+				return CHandle();
 			}
 		}
-		DC_WARNING_MSG(EErrorCode::GameObjectChildNotFound, "Child %s doesn't belong to this gameObject", name.c_str());
+		return child;
+	}
+
+	CHandle CGameObject::GetChildByName(CStrID nameId)
+	{
+		if (m_children.size() - m_numRemovedChildren >= CHILDREN_BY_NAME_MIN_CHILDREN)
+		{
+			if (!m_childrenByNameValid)
+			{
+				m_childrenByName.clear();
+				for (CGameObject* child : m_children)
+				{
+					if (child)
+					{
+						m_childrenByName.emplace(child->m_name, child);
+					}
+				}
+				m_childrenByNameValid = true;
+			}
+
+			std::unordered_map<CStrID, CHandle>::iterator it = m_childrenByName.find(nameId);
+			if (it != m_childrenByName.end())
+			{
+				return it->second;
+			}
+		}
+		else
+		{
+			for (CGameObject* child : m_children)
+			{
+				if (child && child->m_name == nameId)
+				{
+					return child;
+				}
+			}
+		}
+		DC_WARNING_MSG(EErrorCode::GameObjectChildNotFound, "Child %s doesn't belong to this gameObject", CStrIDTable::GetString(nameId));
 		return CHandle();
 	}
 
 	CHandle CGameObject::GetChildByIndex(std::size_t index)
 	{
+		if (m_numRemovedChildren > 0)
+		{
+			CompactChildren();
+		}
 		if (index < m_children.size())
 		{
 			return m_children[index];
@@ -170,6 +383,18 @@ namespace DonerComponents
 		return false;
 	}
 
+	bool CGameObject::RemoveComponentInternal(CComponent* component)
+	{
+		for (CComponent*& ownComponent : m_components)
+		{
+			if (ownComponent == component)
+			{
+				return m_componentFactoryManager.DestroyComponent(&ownComponent);
+			}
+		}
+		return false;
+	}
+
 	CHandle CGameObject::GetComponent(CStrID nameId)
 	{
 		int componentIdx = m_componentFactoryManager.GetFactoryIndexByName(nameId);
@@ -193,90 +418,141 @@ namespace DonerComponents
 
 	void CGameObject::Init()
 	{
-		if (!m_initialized)
+		// Flagged on a second pass, so descendants still see their ancestors uninitialized
+		// from their components Init, the same as when this was recursive
+		VisitSubtree([](CGameObject* gameObject)
 		{
-			for (CComponent* component : m_components)
+			if (gameObject->m_initialized)
+			{
+				return false;
+			}
+			for (CComponent* component : gameObject->m_components)
 			{
 				if (component)
 				{
 					component->Init();
 				}
 			}
-			for (CGameObject* child : m_children)
+			return true;
+		});
+		VisitSubtree([](CGameObject* gameObject)
+		{
+			if (gameObject->m_initialized)
 			{
-				if (child)
-				{
-					child->Init();
-				}
+				return false;
 			}
-
-			m_initialized = true;
-		}
+			gameObject->m_initialized = true;
+			return true;
+		});
 	}
 
 	void CGameObject::Destroy()
 	{
+		CCommandBuffer* commandBuffer = CCommandBuffer::GetCurrent();
+		if (commandBuffer)
+		{
+			commandBuffer->Destroy(this);
+			return;
+		}
+
 		SetParent(nullptr);
 		DestroyInternal();
 	}
 
 	void CGameObject::DestroyInternal()
 	{
-		if (!m_destroyed)
+		VisitSubtree([](CGameObject* gameObject)
 		{
-			for (CComponent* component : m_components)
+			if (gameObject->m_destroyed)
+			{
+				return false;
+			}
+			for (CComponent* component : gameObject->m_components)
 			{
 				if (component)
 				{
 					component->Destroy();
 				}
 			}
-
-			for (CGameObject* child : m_children)
+			return true;
+		});
+		VisitSubtree([this](CGameObject* gameObject)
+		{
+			if (gameObject->m_destroyed)
 			{
-				if (child)
-				{
-					child->DestroyInternal();
-				}
+				return false;
 			}
+			gameObject->m_destroyed = true;
+			m_gameObjectManager.RemoveFromNameIndex(gameObject);
+			m_gameObjectManager.ScheduleDestroy(gameObject);
+			return true;
+		});
+	}
 
-			m_destroyed = true;
-			m_gameObjectManager.ScheduleDestroy(this);
-		}
+	void CGameObject::MarkAsPrefab()
+	{
+		VisitSubtree([this](CGameObject* gameObject)
+		{
+			m_gameObjectManager.RemoveFromNameIndex(gameObject);
+			gameObject->m_prefab = true;
+			return true;
+		});
 	}
 
 	void CGameObject::Activate()
+	{
+		if (m_gameObjectManager.m_deferredActivation)
+		{
+			m_gameObjectManager.QueueActivation(this, true);
+			return;
+		}
+		ActivateNow();
+	}
+
+	void CGameObject::Deactivate()
+	{
+		if (m_gameObjectManager.m_deferredActivation)
+		{
+			m_gameObjectManager.QueueActivation(this, false);
+			return;
+		}
+		DeactivateNow();
+	}
+
+	std::size_t CGameObject::ActivateNow()
 	{
 		if (m_initialized && m_numDeactivations > 0)
 		{
 			m_numDeactivations = 0;
-			ActivateInternal();
+			return ActivateInternal();
 		}
+		return 0;
 	}
 
-	void CGameObject::Deactivate()
+	std::size_t CGameObject::DeactivateNow()
 	{
-		if (m_initialized)
+		std::size_t numVisited = 0;
+		VisitSubtree([&numVisited](CGameObject* gameObject)
 		{
-			if (m_numDeactivations == 0)
+			++numVisited;
+			if (!gameObject->m_initialized)
 			{
-				for (CComponent* component : m_components)
+				return false;
+			}
+			if (gameObject->m_numDeactivations == 0)
+			{
+				for (CComponent* component : gameObject->m_components)
 				{
 					if (component)
 					{
 						component->Deactivate();
 					}
 				}
-				++m_numDeactivations;
-			}
-			for (CGameObject* child : m_children)
-			{
-				if (child)
-				{
-					child->Deactivate();
-				}
+				++gameObject->m_numDeactivations;
 			}
-		}
+			return true;
+		});
+		return numVisited;
 	}
 
 	void CGameObject::ActivateFromParent()
@@ -291,28 +567,42 @@ namespace DonerComponents
 		}
 	}
 
-	void CGameObject::ActivateInternal()
+	std::size_t CGameObject::ActivateInternal()
 	{
-		for (CComponent* component : m_components)
+		// Descendants still deactivated by themselves or by another ancestor block their subtree
+		std::size_t numVisited = 0;
+		VisitSubtree([this, &numVisited](CGameObject* gameObject)
 		{
-			if (component)
+			++numVisited;
+			if (gameObject != this)
 			{
-				component->ActivateFromParent();
+				if (gameObject->m_numDeactivations == 0 || --gameObject->m_numDeactivations > 0)
+				{
+					return false;
+				}
 			}
-		}
-		for (CGameObject* child : m_children)
-		{
-			if (child)
+			for (CComponent* component : gameObject->m_components)
 			{
-				child->ActivateFromParent();
+				if (component)
+				{
+					component->ActivateFromParent();
+				}
 			}
-		}
+			return true;
+		});
+		return numVisited;
 	}
 
 	void CGameObject::CheckFirstActivation()
 	{
 		if (m_initialized)
 		{
+			// Its counters are reset below, so the queued calls have to be applied before
+			if (!m_gameObjectManager.m_pendingActivations.empty())
+			{
+				m_gameObjectManager.ExecutePendingActivations();
+			}
+
 			for (CGameObject* child : m_children)
 			{
 				if (child)
@@ -337,7 +627,7 @@ namespace DonerComponents
 			else
 			{
 				m_numDeactivations = 0;
-				Deactivate();
+				DeactivateNow();
 			}
 		}
 	}
@@ -374,7 +664,6 @@ namespace DonerComponents
 		if (gameObject)
 		{
 			SetParent(nullptr);
-			SetName(gameObject->GetName());
 
 			m_tags.reset();
 			m_tags |= gameObject->m_tags;
@@ -384,6 +673,9 @@ namespace DonerComponents
 			m_destroyed = gameObject->m_destroyed;
 			m_initiallyActive =gameObject->m_initiallyActive;
 
+			// Once m_destroyed is copied, so destroyed game objects don't get into the name index
+			SetName(gameObject->GetName());
+
 			m_componentFactoryManager.CloneComponents(gameObject->m_components, m_components);
 			for (CComponent* component : m_components)
 			{
@@ -418,9 +710,169 @@ namespace DonerComponents
 
 	CGameObjectManager::CGameObjectManager()
 		: CFactory(MAX_GAME_OBJECTS)
-	{}
+		, m_currentPostMsgQueue(0)
+		, m_postMsgDelivery(EPostMsgDelivery::Ordered)
+		, m_postMsgBudget(0)
+		, m_mainThreadId(std::this_thread::get_id())
+		, m_delayedPostMsgs(DELAYED_POST_MSG_RESOLUTION)
+		, m_numScheduledDestroys(0)
+		, m_nameIndexEnabled(false)
+		, m_pendingActivationsBegin(0)
+		, m_pendingActivationsBase(0)
+		, m_activationBudget(0)
+		, m_deferredActivation(false)
+	{
+		std::size_t numWorkers = CDonerComponentsSystems::Get()->GetJobSystem()->GetNumWorkers();
+		for (std::size_t i = 0; i <= numWorkers; ++i)
+		{
+			m_threadPostMsgs.emplace_back(new SThreadPostMsgs());
+		}
+		m_threadReadBuffers.resize(m_threadPostMsgs.size());
+		m_scheduledDestroyMask.Resize(MAX_GAME_OBJECTS);
+	}
 
 
+	CComponent* CGameObjectManager::GetNextBroadcastTarget(SBroadcastCursor& cursor) const
+	{
+		CComponentFactoryManager* componentFactoryManager = CDonerComponentsSystems::Get()->GetComponentFactoryManager();
+		while (IComponentFactory* factory = componentFactoryManager->GetMessageSubscriber(cursor.m_messageIdx, cursor.m_subscriber))
+		{
+			for (std::size_t position = factory->GetNextLive(cursor.m_position); position < factory->GetCapacity(); position = factory->GetNextLive(position + 1))
+			{
+				CComponent* component = factory->GetComponentAt(position);
+				CGameObject* owner = component->GetOwner();
+				if (owner && owner->IsActive() && !owner->IsDestroyed())
+				{
+					cursor.m_position = position + 1;
+					return component;
+				}
+			}
+			++cursor.m_subscriber;
+			cursor.m_position = 0;
+		}
+		return nullptr;
+	}
+
+	CGameObjectManager::SThreadPostMsgs::SThreadPostMsgs()
+		: m_writeBuffer(0)
+		, m_writingBuffer(0)
+	{
+		for (SJobPostMsgs (&buffer)[static_cast<std::size_t>(EPostMsgPriority::Count)] : m_buffers)
+		{
+			for (SJobPostMsgs& jobPostMsgs : buffer)
+			{
+				jobPostMsgs.m_postMsgs.SetCoalescingEnabled(false);
+				jobPostMsgs.m_numRuns = 0;
+			}
+		}
+	}
+
+	CGameObjectManager::SJobPostMsgs& CGameObjectManager::SThreadPostMsgs::BeginWrite(EPostMsgPriority priority)
+	{
+		// If SwapBuffers switches buffers in between, write to the new one instead
+		std::size_t buffer = m_writeBuffer.load();
+		while (true)
+		{
+			m_writingBuffer.store(buffer + 1);
+			std::size_t writeBuffer = m_writeBuffer.load();
+			if (writeBuffer == buffer)
+			{
+				return m_buffers[buffer][static_cast<std::size_t>(priority)];
+			}
+			buffer = writeBuffer;
+		}
+	}
+
+	void CGameObjectManager::SThreadPostMsgs::EndWrite(SJobPostMsgs& jobPostMsgs)
+	{
+		CJobSystem::SJobContext* context = CJobSystem::GetCurrentJobContext();
+		SPostMsgRun* run = jobPostMsgs.m_numRuns > 0 ? &jobPostMsgs.m_runs[jobPostMsgs.m_numRuns - 1] : nullptr;
+		if (!run || run->m_context != context || run->m_nextSequence != context->m_sequence)
+		{
+			if (jobPostMsgs.m_numRuns == jobPostMsgs.m_runs.size())
+			{
+				jobPostMsgs.m_runs.emplace_back();
+			}
+			run = &jobPostMsgs.m_runs[jobPostMsgs.m_numRuns++];
+			run->m_key = context->m_key;
+			run->m_context = context;
+			run->m_sequence = context->m_sequence;
+			run->m_begin = jobPostMsgs.m_postMsgs.GetSize() - 1;
+		}
+		run->m_nextSequence = ++context->m_sequence;
+		run->m_end = jobPostMsgs.m_postMsgs.GetSize();
+		m_writingBuffer.store(0);
+	}
+
+	std::size_t CGameObjectManager::SThreadPostMsgs::SwapBuffers()
+	{
+		std::size_t readBuffer = m_writeBuffer.load();
+		m_writeBuffer.store(1 - readBuffer);
+		while (m_writingBuffer.load() == readBuffer + 1)
+		{
+			std::this_thread::yield();
+		}
+		return readBuffer;
+	}
+
+	CGameObjectManager::SThreadPostMsgs* CGameObjectManager::GetJobThreadPostMsgs()
+	{
+		if (!CJobSystem::GetCurrentJobContext())
+		{
+			return nullptr;
+		}
+		CJobSystem* jobSystem = CDonerComponentsSystems::Get()->GetJobSystem();
+		std::size_t workerIdx = jobSystem->GetCurrentWorkerIdx();
+		if (workerIdx == jobSystem->GetNumWorkers() && std::this_thread::get_id() != m_mainThreadId)
+		{
+			return nullptr;
+		}
+		return m_threadPostMsgs[workerIdx].get();
+	}
+
+	void CGameObjectManager::MergeJobPostMsgs()
+	{
+		for (std::size_t i = 0; i < m_threadPostMsgs.size(); ++i)
+		{
+			m_threadReadBuffers[i] = m_threadPostMsgs[i]->SwapBuffers();
+		}
+
+		for (std::size_t priority = 0; priority < static_cast<std::size_t>(EPostMsgPriority::Count); ++priority)
+		{
+			m_postMsgRunRefs.clear();
+			for (std::size_t i = 0; i < m_threadPostMsgs.size(); ++i)
+			{
+				SJobPostMsgs& jobPostMsgs = m_threadPostMsgs[i]->m_buffers[m_threadReadBuffers[i]][priority];
+				for (std::size_t run = 0; run < jobPostMsgs.m_numRuns; ++run)
+				{
+					m_postMsgRunRefs.push_back({ &jobPostMsgs.m_runs[run], &jobPostMsgs.m_postMsgs });
+				}
+			}
+
+			std::sort(m_postMsgRunRefs.begin(), m_postMsgRunRefs.end(), [](const SPostMsgRunRef& lhs, const SPostMsgRunRef& rhs)
+			{
+				if (lhs.m_run->m_key != rhs.m_run->m_key)
+				{
+					return lhs.m_run->m_key < rhs.m_run->m_key;
+				}
+				return lhs.m_run->m_sequence < rhs.m_run->m_sequence;
+			});
+
+			CPostMsgQueue& postMsgs = GetPostMsgQueue(static_cast<EPostMsgPriority>(priority));
+			for (const SPostMsgRunRef& runRef : m_postMsgRunRefs)
+			{
+				runRef.m_postMsgs->MoveRangeTo(runRef.m_run->m_begin, runRef.m_run->m_end, postMsgs);
+			}
+
+			for (std::size_t i = 0; i < m_threadPostMsgs.size(); ++i)
+			{
+				SJobPostMsgs& jobPostMsgs = m_threadPostMsgs[i]->m_buffers[m_threadReadBuffers[i]][priority];
+				jobPostMsgs.m_postMsgs.Clear();
+				jobPostMsgs.m_numRuns = 0;
+			}
+		}
+	}
+
 	CGameObject* CGameObjectManager::CreateGameObject()
 	{
 		CGameObject* gameObject = GetNewElement();
@@ -428,45 +880,414 @@ namespace DonerComponents
 		{
 			DC_ERROR_MSG(EErrorCode::NoMoreGameObjectsAvailable, "No more GameObjects available for creation at this point");
 		}
+		else if (m_flatHierarchy)
+		{
+			m_flatHierarchy->AddSubtree(gameObject);
+		}
 		return gameObject;
 	}
 
-	bool CGameObjectManager::DestroyGameObject(CHandle handle)
+	void CGameObjectManager::DestroyGameObjectAt(std::size_t position)
 	{
-		CGameObject* gameObject = handle;
-		if (FindElement(gameObject))
+		CGameObject* gameObject = m_entries[position].m_data;
+		if (m_flatHierarchy)
 		{
-			return DestroyElement(&gameObject);
+			m_flatHierarchy->Remove(gameObject);
 		}
-		DC_WARNING_MSG(EErrorCode::GameObjectNotRegisteredInFactory, "Trying to destroy an gameObject which hasn't been created using CGameObjectManager");
-		return false;
+		DestroyElement(&gameObject);
+	}
+
+	void CGameObjectManager::UpdateDelayedPostMsgs(float dt)
+	{
+		m_delayedPostMsgs.Advance(dt, GetPostMsgQueue(EPostMsgPriority::Normal));
 	}
 
 	void CGameObjectManager::SendPostMsgs()
 	{
-		std::vector<CPostMessageBase*> currentMsgs = m_postMsgs;
-		m_postMsgs.clear();
-		for (CPostMessageBase* postMsg : currentMsgs)
+		// Job messages go after the main thread ones, by job key, so their order doesn't depend on
+		// which worker ran each job. Messages from threads outside the job system go last
+		MergeJobPostMsgs();
+		{
+			std::lock_guard<std::mutex> lock(m_otherThreadPostMsgs.m_mutex);
+			for (std::size_t i = 0; i < static_cast<std::size_t>(EPostMsgPriority::Count); ++i)
+			{
+				m_otherThreadPostMsgs.m_postMsgs[i].MoveTo(GetPostMsgQueue(static_cast<EPostMsgPriority>(i)));
+			}
+		}
+
+		CPostMsgQueue* postMsgs = m_postMsgQueues[m_currentPostMsgQueue];
+		m_currentPostMsgQueue = 1 - m_currentPostMsgQueue;
+
+		std::size_t numSent = 0;
+		for (std::size_t i = 0; i < static_cast<std::size_t>(EPostMsgPriority::Low); ++i)
+		{
+			numSent += postMsgs[i].GetSize();
+			SendPostMsgs(postMsgs[i]);
+		}
+
+		CPostMsgQueue& lowPriorityPostMsgs = postMsgs[static_cast<std::size_t>(EPostMsgPriority::Low)];
+		if (m_postMsgBudget == 0)
+		{
+			SendLowPriorityPostMsgs(lowPriorityPostMsgs, std::numeric_limits<std::size_t>::max());
+		}
+		else
+		{
+			SendLowPriorityPostMsgs(lowPriorityPostMsgs, m_postMsgBudget > numSent ? m_postMsgBudget - numSent : 0);
+		}
+	}
+
+	std::size_t CGameObjectManager::GetCarriedPostMsgsCount() const
+	{
+		std::size_t count = 0;
+		for (const std::unique_ptr<CPostMsgQueue>& carriedPostMsgs : m_carriedPostMsgs)
+		{
+			count += carriedPostMsgs->GetSize();
+		}
+		return count;
+	}
+
+	void CGameObjectManager::SendPostMsgs(CPostMsgQueue& postMsgs)
+	{
+		if (m_postMsgDelivery == EPostMsgDelivery::Batched)
 		{
-			postMsg->SendMessage();
-			delete postMsg;
+			postMsgs.SendAllBatched();
+		}
+		else
+		{
+			postMsgs.SendAll();
 		}
 	}
 
-	void CGameObjectManager::ScheduleDestroy(CHandle handle)
+	void CGameObjectManager::SendLowPriorityPostMsgs(CPostMsgQueue& postMsgs, std::size_t maxPostMsgs)
 	{
-		if (std::find(m_scheduledDestroys.begin(), m_scheduledDestroys.end(), handle) == m_scheduledDestroys.end())
+		// Carried messages go first, so low priority messages are still sent in posting order
+		while (maxPostMsgs > 0 && !m_carriedPostMsgs.empty())
+		{
+			CPostMsgQueue& carriedPostMsgs = *m_carriedPostMsgs.front();
+			maxPostMsgs -= carriedPostMsgs.SendFront(maxPostMsgs);
+			if (carriedPostMsgs.IsEmpty())
+			{
+				m_freePostMsgQueues.emplace_back(std::move(m_carriedPostMsgs.front()));
+				m_carriedPostMsgs.pop_front();
+			}
+		}
+
+		if (m_carriedPostMsgs.empty() && postMsgs.GetSize() <= maxPostMsgs)
+		{
+			SendPostMsgs(postMsgs);
+			return;
+		}
+
+		if (m_carriedPostMsgs.empty())
 		{
-			m_scheduledDestroys.emplace_back(handle);
+			postMsgs.SendFront(maxPostMsgs);
+		}
+
+		if (!postMsgs.IsEmpty())
+		{
+			if (m_freePostMsgQueues.empty())
+			{
+				m_freePostMsgQueues.emplace_back(new CPostMsgQueue());
+			}
+			m_carriedPostMsgs.emplace_back(std::move(m_freePostMsgQueues.back()));
+			m_freePostMsgQueues.pop_back();
+			postMsgs.MoveTo(*m_carriedPostMsgs.back());
+		}
+	}
+
+	void CGameObjectManager::ScheduleDestroy(CGameObject* gameObject)
+	{
+		int position = GetPositionForElement(gameObject);
+		if (position == -1)
+		{
+			DC_WARNING_MSG(EErrorCode::GameObjectNotRegisteredInFactory, "Trying to destroy an gameObject which hasn't been created using CGameObjectManager");
+			return;
+		}
+		if (!m_scheduledDestroyMask.Get(position))
+		{
+			m_scheduledDestroyMask.Set(position, true);
+			++m_numScheduledDestroys;
 		}
 	}
 
 	void CGameObjectManager::ExecuteScheduledDestroys()
 	{
-		for (CHandle handle : m_scheduledDestroys)
+		std::size_t position = m_scheduledDestroyMask.GetNextSet(0);
+		while (m_numScheduledDestroys > 0 && position < m_numElements)
+		{
+			m_scheduledDestroyMask.Set(position, false);
+			--m_numScheduledDestroys;
+			DestroyGameObjectAt(position);
+			position = m_scheduledDestroyMask.GetNextSet(position + 1);
+		}
+
+		if (m_flatHierarchy)
+		{
+			m_flatHierarchy->Compact();
+		}
+	}
+
+	void CGameObjectManager::SetFlatHierarchyEnabled(bool enabled)
+	{
+		if (!enabled)
+		{
+			if (m_flatHierarchy)
+			{
+				m_flatHierarchy->Clear();
+				m_flatHierarchy.reset();
+			}
+			return;
+		}
+
+		if (!m_flatHierarchy)
+		{
+			m_flatHierarchy.reset(new CFlatHierarchy());
+			for (SEntry& entry : m_entries)
+			{
+				if (entry.m_used && !entry.m_data->GetParent())
+				{
+					m_flatHierarchy->AddSubtree(entry.m_data);
+				}
+			}
+			// Game objects whose parent doesn't list them as a child
+			for (SEntry& entry : m_entries)
+			{
+				if (entry.m_used && !m_flatHierarchy->Contains(entry.m_data))
+				{
+					m_flatHierarchy->AddSubtree(entry.m_data);
+				}
+			}
+		}
+	}
+
+	void CGameObjectManager::SetNameIndexEnabled(bool enabled)
+	{
+		if (enabled == m_nameIndexEnabled)
+		{
+			return;
+		}
+
+		m_nameIndexEnabled = enabled;
+		m_gameObjectsByName.clear();
+		for (SEntry& entry : m_entries)
+		{
+			if (entry.m_used)
+			{
+				entry.m_data->m_nameIndexPosition = INVALID_NAME_INDEX_POSITION;
+				AddToNameIndex(entry.m_data);
+			}
+		}
+	}
+
+	CHandle CGameObjectManager::GetGameObjectByName(CStrID name)
+	{
+		if (m_nameIndexEnabled)
+		{
+			auto it = m_gameObjectsByName.find(name);
+			return it != m_gameObjectsByName.end() ? it->second.front().m_handle : CHandle();
+		}
+
+		for (SEntry& entry : m_entries)
+		{
+			if (entry.m_used && !entry.m_data->IsDestroyed() && !entry.m_data->m_prefab && entry.m_data->GetName() == name)
+			{
+				return entry.m_data;
+			}
+		}
+		return CHandle();
+	}
+
+	std::vector<CHandle> CGameObjectManager::GetGameObjectsByName(CStrID name)
+	{
+		std::vector<CHandle> gameObjects;
+		if (m_nameIndexEnabled)
+		{
+			auto it = m_gameObjectsByName.find(name);
+			if (it != m_gameObjectsByName.end())
+			{
+				for (const SNamedGameObject& namedGameObject : it->second)
+				{
+					gameObjects.emplace_back(namedGameObject.m_handle);
+				}
+			}
+			return gameObjects;
+		}
+
+		for (SEntry& entry : m_entries)
+		{
+			if (entry.m_used && !entry.m_data->IsDestroyed() && !entry.m_data->m_prefab && entry.m_data->GetName() == name)
+			{
+				gameObjects.emplace_back(entry.m_data);
+			}
+		}
+		return gameObjects;
+	}
+
+	void CGameObjectManager::AddToNameIndex(CGameObject* gameObject)
+	{
+		if (m_nameIndexEnabled && gameObject->GetName() != CStrID() && !gameObject->IsDestroyed() && !gameObject->m_prefab)
+		{
+			std::vector<SNamedGameObject>& gameObjects = m_gameObjectsByName[gameObject->GetName()];
+			gameObject->m_nameIndexPosition = gameObjects.size();
+			gameObjects.emplace_back(gameObject, *gameObject);
+		}
+	}
+
+	void CGameObjectManager::RemoveFromNameIndex(CGameObject* gameObject)
+	{
+		std::size_t position = gameObject->m_nameIndexPosition;
+		if (position == INVALID_NAME_INDEX_POSITION)
+		{
+			return;
+		}
+
+		gameObject->m_nameIndexPosition = INVALID_NAME_INDEX_POSITION;
+		auto it = m_gameObjectsByName.find(gameObject->GetName());
+		if (it != m_gameObjectsByName.end())
+		{
+			// Swapped with the last one, so the others keep their position
+			std::vector<SNamedGameObject>& gameObjects = it->second;
+			if (position + 1 < gameObjects.size())
+			{
+				gameObjects[position] = gameObjects.back();
+				gameObjects[position].m_gameObject->m_nameIndexPosition = position;
+			}
+			gameObjects.pop_back();
+			if (gameObjects.empty())
+			{
+				m_gameObjectsByName.erase(it);
+			}
+		}
+	}
+
+	void CGameObjectManager::SetDeferredActivationEnabled(bool enabled)
+	{
+		m_deferredActivation = enabled;
+		if (!enabled)
+		{
+			ExecutePendingActivations();
+		}
+	}
+
+	void CGameObjectManager::ExecutePendingActivations(std::size_t maxGameObjects/* = 0*/)
+	{
+		// Calls queued by the callbacks wait for the next execution
+		std::size_t end = m_pendingActivations.size();
+		std::size_t numVisited = 0;
+		while (m_pendingActivationsBegin < end && (maxGameObjects == 0 || numVisited < maxGameObjects))
+		{
+			// Copied, the callbacks may queue more calls
+			SPendingActivation pendingActivation = m_pendingActivations[m_pendingActivationsBegin++];
+			CGameObject* gameObject = pendingActivation.m_handle;
+			if (gameObject)
+			{
+				// Unlinked first, so IsActive doesn't replay it while it's being applied
+				gameObject->m_firstPendingActivation = pendingActivation.m_next;
+				if (pendingActivation.m_next == INVALID_PENDING_ACTIVATION)
+				{
+					gameObject->m_lastPendingActivation = INVALID_PENDING_ACTIVATION;
+				}
+				numVisited += pendingActivation.m_activate ? gameObject->ActivateNow() : gameObject->DeactivateNow();
+			}
+		}
+
+		if (m_pendingActivationsBegin * 2 >= m_pendingActivations.size())
+		{
+			m_pendingActivations.erase(m_pendingActivations.begin(), m_pendingActivations.begin() + m_pendingActivationsBegin);
+			m_pendingActivationsBase += m_pendingActivationsBegin;
+			m_pendingActivationsBegin = 0;
+		}
+	}
+
+	void CGameObjectManager::QueueActivation(CGameObject* gameObject, bool activate)
+	{
+		std::size_t sequence = m_pendingActivationsBase + m_pendingActivations.size();
+		m_pendingActivations.emplace_back(*gameObject, activate);
+		if (gameObject->m_lastPendingActivation == INVALID_PENDING_ACTIVATION)
+		{
+			gameObject->m_firstPendingActivation = sequence;
+		}
+		else
+		{
+			GetPendingActivation(gameObject->m_lastPendingActivation).m_next = sequence;
+		}
+		gameObject->m_lastPendingActivation = sequence;
+	}
+
+	bool CGameObjectManager::IsActiveAfterPendingActivations(const CGameObject* gameObject) const
+	{
+		// Activate and Deactivate only change the counters on the path from the game object they're
+		// called on to each descendant, so replaying the calls queued on its ancestors is enough
+		bool pending = false;
+		for (const CGameObject* ancestor = gameObject; ancestor && !pending; ancestor = ancestor->Resolve(ancestor->m_parent))
+		{
+			pending = ancestor->m_firstPendingActivation != INVALID_PENDING_ACTIVATION;
+		}
+		if (!pending)
 		{
-			DestroyGameObject(handle);
+			return gameObject->m_numDeactivations == 0;
+		}
+
+		struct SAncestor
+		{
+			const CGameObject* m_gameObject;
+			int m_numDeactivations;
+			// Next call queued on this ancestor to replay
+			std::size_t m_next;
+		};
+		// Reused, so queries don't allocate once it's grown to the hierarchy depth
+		static thread_local std::vector<SAncestor> s_ancestors;
+		std::vector<SAncestor>& ancestors = s_ancestors;
+		ancestors.clear();
+		for (const CGameObject* ancestor = gameObject; ancestor; ancestor = ancestor->Resolve(ancestor->m_parent))
+		{
+			ancestors.push_back({ ancestor, ancestor->m_numDeactivations, ancestor->m_firstPendingActivation });
+		}
+		std::reverse(ancestors.begin(), ancestors.end());
+
+		// Merges the calls queued on each ancestor in sequence order
+		while (true)
+		{
+			std::size_t first = ancestors.size();
+			for (std::size_t i = 0; i < ancestors.size(); ++i)
+			{
+				if (ancestors[i].m_next != INVALID_PENDING_ACTIVATION && (first == ancestors.size() || ancestors[i].m_next < ancestors[first].m_next))
+				{
+					first = i;
+				}
+			}
+			if (first == ancestors.size())
+			{
+				break;
+			}
+
+			const SPendingActivation& pendingActivation = GetPendingActivation(ancestors[first].m_next);
+			ancestors[first].m_next = pendingActivation.m_next;
+			if (pendingActivation.m_activate)
+			{
+				if (ancestors[first].m_gameObject->m_initialized && ancestors[first].m_numDeactivations > 0)
+				{
+					ancestors[first].m_numDeactivations = 0;
+					for (std::size_t i = first + 1; i < ancestors.size() && ancestors[i].m_numDeactivations > 0; ++i)
+					{
+						if (--ancestors[i].m_numDeactivations > 0)
+						{
+							break;
+						}
+					}
+				}
+			}
+			else
+			{
+				for (std::size_t i = first; i < ancestors.size() && ancestors[i].m_gameObject->m_initialized; ++i)
+				{
+					if (ancestors[i].m_numDeactivations == 0)
+					{
+						ancestors[i].m_numDeactivations = 1;
+					}
+				}
+			}
 		}
-		m_scheduledDestroys.clear();
+		return ancestors.back().m_numDeactivations == 0;
 	}
 }
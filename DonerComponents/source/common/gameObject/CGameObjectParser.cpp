@@ -34,10 +34,25 @@
 #include <donercomponents/component/CComponent.h>
 #include <donercomponents/utils/memory/CMemoryDataProvider.h>
 #include <donercomponents/utils/hash/CStrID.h>
+#include <donercomponents/utils/hash/CStrIDTable.h>
 #include <donercomponents/component/CComponentFactoryManager.h>
+#include <donercomponents/jobs/CJobSystem.h>
+
+#include <memory>
 
 namespace DonerComponents
 {
+	namespace
+	{
+		struct SAsyncParseData
+		{
+			std::string m_path;
+			rapidjson::Document m_document;
+			bool m_loaded;
+			SAsyncParseData(const char* const path) : m_path(path), m_loaded(false) {}
+		};
+	}
+
 	CGameObjectParser::CGameObjectParser()
 		: m_gameObjectManager(*CDonerComponentsSystems::Get()->GetGameObjectManager())
 		, m_prefabManager(*CDonerComponentsSystems::Get()->GetPrefabManager())
@@ -73,17 +88,24 @@ namespace DonerComponents
 		return ParseFromJson(jsonStr, EParsedGameObjectType::Prefab);
 	}
 
+	void CGameObjectParser::ParseSceneFromFileAsync(const char* const path, TParsedCallback callback)
+	{
+		ParseFromFileAsync(path, EParsedGameObjectType::Scene, callback);
+	}
+
+	void CGameObjectParser::ParsePrefabFromFileAsync(const char* const path, TParsedCallback callback)
+	{
+		ParseFromFileAsync(path, EParsedGameObjectType::Prefab, callback);
+	}
+
 	CHandle CGameObjectParser::ParseFromFile(const char* const path, EParsedGameObjectType type)
 	{
-		CMemoryDataProvider mdp(path);
-		if (!mdp.IsValid())
+		rapidjson::Document document;
+		if (LoadDocument(path, document))
 		{
-			DC_ERROR_MSG(EErrorCode::FileNotFound, "error opening %s", path);
-			return CHandle();
+			return ParseFromDocument(document, type);
 		}
-
-		std::string zeroTerminatedStr((const char*)mdp.GetBaseData(), mdp.GetSize());
-		return ParseFromJson(zeroTerminatedStr.c_str(), type);
+		return CHandle();
 	}
 
 	CHandle CGameObjectParser::ParseFromMemory(const unsigned char* jsonStringBuffer, std::size_t size, EParsedGameObjectType type)
@@ -101,19 +123,67 @@ namespace DonerComponents
 	CHandle CGameObjectParser::ParseFromJson(const char* const jsonStr, EParsedGameObjectType type)
 	{
 		rapidjson::Document document;
-		rapidjson::Value& root = document.Parse(jsonStr);
+		if (ParseDocument(jsonStr, document))
+		{
+			return ParseFromDocument(document, type);
+		}
+		return CHandle();
+	}
 
-		CHandle result;
+	void CGameObjectParser::ParseFromFileAsync(const char* const path, EParsedGameObjectType type, TParsedCallback callback)
+	{
+		CJobSystem* jobSystem = CDonerComponentsSystems::Get()->GetJobSystem();
+		std::shared_ptr<SAsyncParseData> data = std::make_shared<SAsyncParseData>(path);
+		jobSystem->Submit([data, type, callback, jobSystem]()
+		{
+			data->m_loaded = LoadDocument(data->m_path.c_str(), data->m_document);
+			jobSystem->SubmitToMainThread([data, type, callback]()
+			{
+				CHandle result;
+				if (data->m_loaded)
+				{
+					CGameObjectParser parser;
+					result = parser.ParseFromDocument(data->m_document, type);
+				}
+				if (callback)
+				{
+					callback(result);
+				}
+			});
+		});
+	}
+
+	bool CGameObjectParser::LoadDocument(const char* const path, rapidjson::Document& document)
+	{
+		CMemoryDataProvider mdp(path);
+		if (!mdp.IsValid())
+		{
+			DC_ERROR_MSG(EErrorCode::FileNotFound, "error opening %s", path);
+			return false;
+		}
+
+		std::string zeroTerminatedStr((const char*)mdp.GetBaseData(), mdp.GetSize());
+		return ParseDocument(zeroTerminatedStr.c_str(), document);
+	}
+
+	bool CGameObjectParser::ParseDocument(const char* const jsonStr, rapidjson::Document& document)
+	{
+		document.Parse(jsonStr);
 		if (document.HasParseError())
 		{
 			rapidjson::ParseErrorCode error = document.GetParseError();
 			DC_ERROR_MSG(EErrorCode::JSONError, "Error processing Json: %d", error);
-			return result;
+			return false;
 		}
+		return true;
+	}
 
-		if (root.HasMember("root"))
+	CHandle CGameObjectParser::ParseFromDocument(const rapidjson::Document& document, EParsedGameObjectType type)
+	{
+		CHandle result;
+		if (document.HasMember("root"))
 		{
-			rapidjson::Value& rootGameObject = root["root"];
+			const rapidjson::Value& rootGameObject = document["root"];
 
 			switch (type)
 			{
@@ -158,7 +228,7 @@ namespace DonerComponents
 
 		if (gameObjectData.HasMember("name"))
 		{
-			gameObject->SetName(gameObjectData["name"].GetString());
+			gameObject->SetName(CStrIDTable::Register(gameObjectData["name"].GetString()));
 		}
 
 		ParseOverrideableData(gameObjectData, gameObject);
@@ -211,7 +281,7 @@ namespace DonerComponents
 		}
 		else if (!tags.IsNull())
 		{
-			DC_ERROR_MSG(EErrorCode::JSONBadFormat, "Your tags info for gameObject '%s' is bad formatted", gameObject->GetName().c_str());
+			DC_ERROR_MSG(EErrorCode::JSONBadFormat, "Your tags info for gameObject '%s' is bad formatted", CStrIDTable::GetString(gameObject->GetName()));
 		}
 		return false;
 	}
@@ -243,7 +313,7 @@ namespace DonerComponents
 		}
 		else if (!components.IsNull())
 		{
-			DC_ERROR_MSG(EErrorCode::JSONBadFormat, "Your components info for gameObject '%s' is bad formatted", gameObject->GetName().c_str());
+			DC_ERROR_MSG(EErrorCode::JSONBadFormat, "Your components info for gameObject '%s' is bad formatted", CStrIDTable::GetString(gameObject->GetName()));
 		}
 		return false;
 	}
@@ -254,7 +324,7 @@ namespace DonerComponents
 		{
 			for (const rapidjson::Value& childJson : children.GetArray())
 			{
-				CGameObject* existingChild = gameObject->GetChildByName(childJson["name"].GetString());
+				CGameObject* existingChild = gameObject->GetChildByName(CStrID(childJson["name"].GetString()));
 				if (existingChild)
 				{
 					ParseOverrideableData(childJson, existingChild);
@@ -268,7 +338,7 @@ namespace DonerComponents
 		}
 		else if (!children.IsNull())
 		{
-			DC_ERROR_MSG(EErrorCode::JSONBadFormat, "Your children info for gameObject '%s' is bad formatted", gameObject->GetName().c_str());
+			DC_ERROR_MSG(EErrorCode::JSONBadFormat, "Your children info for gameObject '%s' is bad formatted", CStrIDTable::GetString(gameObject->GetName()));
 		}
 		return false;
 	}
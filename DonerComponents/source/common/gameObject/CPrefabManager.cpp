@@ -50,6 +50,7 @@ namespace DonerComponents
 	{
 		if (m_prefabs.find(nameId) == m_prefabs.end())
 		{
+			prefab->MarkAsPrefab();
 			m_prefabs[nameId] = prefab;
 			return true;
 		}
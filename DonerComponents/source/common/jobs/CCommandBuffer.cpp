@@ -0,0 +1,108 @@
+////////////////////////////////////////////////////////////
+//
+// MIT License
+//
+// DonerComponents
+// Copyright(c) 2017 Donerkebap13
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+#include <donercomponents/jobs/CCommandBuffer.h>
+#include <donercomponents/CDonerComponentsSystems.h>
+#include <donercomponents/gameObject/CGameObject.h>
+
+namespace DonerComponents
+{
+	thread_local CCommandBuffer* CCommandBuffer::s_current = nullptr;
+
+	CCommandBuffer::CScope::CScope(CCommandBuffer& commandBuffer)
+		: m_previous(s_current)
+	{
+		s_current = &commandBuffer;
+	}
+
+	CCommandBuffer::CScope::~CScope()
+	{
+		s_current = m_previous;
+	}
+
+	CCommandBuffer::CCommandBuffer()
+	{
+		// Messages are coalesced once moved to the GameObjectManager's queues, in merge order
+		for (CPostMsgQueue& postMsgs : m_postMsgs)
+		{
+			postMsgs.SetCoalescingEnabled(false);
+		}
+	}
+
+	CCommandBuffer::~CCommandBuffer()
+	{
+		Clear();
+	}
+
+	void CCommandBuffer::Append(CCommandBuffer& other)
+	{
+		for (std::size_t i = 0; i < static_cast<std::size_t>(EPostMsgPriority::Count); ++i)
+		{
+			other.m_postMsgs[i].MoveTo(m_postMsgs[i]);
+		}
+		m_destroys.insert(m_destroys.end(), other.m_destroys.begin(), other.m_destroys.end());
+		other.m_destroys.clear();
+		m_componentRemovals.insert(m_componentRemovals.end(), other.m_componentRemovals.begin(), other.m_componentRemovals.end());
+		other.m_componentRemovals.clear();
+	}
+
+	void CCommandBuffer::Execute()
+	{
+		for (CHandle handle : m_destroys)
+		{
+			handle.Destroy();
+		}
+		m_destroys.clear();
+
+		for (CHandle handle : m_componentRemovals)
+		{
+			CComponent* component = handle;
+			CGameObject* owner = component ? static_cast<CGameObject*>(component->GetOwner()) : nullptr;
+			if (owner)
+			{
+				owner->RemoveComponentInternal(component);
+			}
+		}
+		m_componentRemovals.clear();
+
+		CGameObjectManager* gameObjectManager = CDonerComponentsSystems::Get()->GetGameObjectManager();
+		for (std::size_t i = 0; i < static_cast<std::size_t>(EPostMsgPriority::Count); ++i)
+		{
+			m_postMsgs[i].MoveTo(gameObjectManager->GetPostMsgQueue(static_cast<EPostMsgPriority>(i)));
+		}
+	}
+
+	void CCommandBuffer::Clear()
+	{
+		for (CPostMsgQueue& postMsgs : m_postMsgs)
+		{
+			postMsgs.Clear();
+		}
+		m_destroys.clear();
+		m_componentRemovals.clear();
+	}
+}
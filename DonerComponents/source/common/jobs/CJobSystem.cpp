@@ -0,0 +1,232 @@
+////////////////////////////////////////////////////////////
+//
+// MIT License
+//
+// DonerComponents
+// Copyright(c) 2017 Donerkebap13
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+#include <donercomponents/jobs/CJobSystem.h>
+
+namespace DonerComponents
+{
+	thread_local CJobSystem* CJobSystem::s_currentJobSystem = nullptr;
+	thread_local std::size_t CJobSystem::s_currentQueueIdx = 0;
+	thread_local CJobSystem::SJobContext* CJobSystem::s_currentJobContext = nullptr;
+
+	CJobSystem::CJobSystem(std::size_t numWorkers)
+		: m_numPendingJobs(0)
+		, m_nextJobKey(0)
+		, m_running(true)
+	{
+		for (std::size_t i = 0; i <= numWorkers; ++i)
+		{
+			m_queues.emplace_back(new SJobQueue());
+		}
+
+		m_workers.reserve(numWorkers);
+		for (std::size_t i = 0; i < numWorkers; ++i)
+		{
+			m_workers.emplace_back(&CJobSystem::WorkerLoop, this, i);
+		}
+	}
+
+	CJobSystem::~CJobSystem()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_sleepMutex);
+			m_running = false;
+		}
+		m_sleepCondition.notify_all();
+		for (std::thread& worker : m_workers)
+		{
+			worker.join();
+		}
+	}
+
+	void CJobSystem::Submit(TJob job)
+	{
+		SubmitWithKey(std::move(job), GetNextJobKey());
+	}
+
+	void CJobSystem::SubmitWithKey(TJob job, TJobKey key)
+	{
+		SJob keyedJob{ std::move(job), std::move(key) };
+		if (m_workers.empty())
+		{
+			RunJob(keyedJob);
+			return;
+		}
+
+		SJobQueue& queue = *m_queues[GetCurrentQueueIdx()];
+		{
+			std::lock_guard<std::mutex> lock(queue.m_mutex);
+			queue.m_jobs.emplace_back(std::move(keyedJob));
+		}
+		++m_numPendingJobs;
+		{
+			std::lock_guard<std::mutex> lock(m_sleepMutex);
+		}
+		m_sleepCondition.notify_one();
+	}
+
+	void CJobSystem::Submit(TJob job, TJob continuation)
+	{
+		Submit([this, job, continuation]()
+		{
+			job();
+			Submit(continuation);
+		});
+	}
+
+	void CJobSystem::SubmitToMainThread(TJob job)
+	{
+		std::lock_guard<std::mutex> lock(m_mainThreadMutex);
+		m_mainThreadJobs.emplace_back(std::move(job));
+	}
+
+	void CJobSystem::ExecuteMainThreadJobs()
+	{
+		// Jobs submitted while executing these ones will be run next time
+		std::vector<TJob> jobs;
+		{
+			std::lock_guard<std::mutex> lock(m_mainThreadMutex);
+			jobs.swap(m_mainThreadJobs);
+		}
+		for (TJob& job : jobs)
+		{
+			job();
+		}
+	}
+
+	void CJobSystem::ParallelFor(std::size_t count, const TParallelForJob& job)
+	{
+		std::atomic<int> remainingJobs(static_cast<int>(count));
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			Submit([&job, &remainingJobs, i]()
+			{
+				job(i);
+				--remainingJobs;
+			});
+		}
+		Wait(remainingJobs);
+	}
+
+	void CJobSystem::Wait(const std::atomic<int>& counter)
+	{
+		std::size_t queueIdx = GetCurrentQueueIdx();
+		while (counter.load() > 0)
+		{
+			if (!RunPendingJob(queueIdx))
+			{
+				std::this_thread::yield();
+			}
+		}
+	}
+
+	void CJobSystem::WorkerLoop(std::size_t queueIdx)
+	{
+		s_currentJobSystem = this;
+		s_currentQueueIdx = queueIdx;
+
+		while (true)
+		{
+			if (!RunPendingJob(queueIdx))
+			{
+				std::unique_lock<std::mutex> lock(m_sleepMutex);
+				m_sleepCondition.wait(lock, [this]() { return !m_running || m_numPendingJobs.load() > 0; });
+				if (!m_running)
+				{
+					return;
+				}
+			}
+		}
+	}
+
+	bool CJobSystem::RunPendingJob(std::size_t queueIdx)
+	{
+		SJob job;
+		if (PopJob(queueIdx, job) || StealJob(queueIdx, job))
+		{
+			--m_numPendingJobs;
+			RunJob(job);
+			return true;
+		}
+		return false;
+	}
+
+	CJobSystem::TJobKey CJobSystem::GetNextJobKey()
+	{
+		if (s_currentJobContext)
+		{
+			TJobKey key = s_currentJobContext->m_key;
+			key.emplace_back(s_currentJobContext->m_numSubmitted++);
+			return key;
+		}
+		return TJobKey(1, m_nextJobKey++);
+	}
+
+	void CJobSystem::RunJob(SJob& job)
+	{
+		// Jobs waiting on other jobs may run them on this same thread
+		SJobContext context(std::move(job.m_key));
+		SJobContext* previousContext = s_currentJobContext;
+		s_currentJobContext = &context;
+		job.m_job();
+		s_currentJobContext = previousContext;
+	}
+
+	bool CJobSystem::PopJob(std::size_t queueIdx, SJob& job)
+	{
+		SJobQueue& queue = *m_queues[queueIdx];
+		std::lock_guard<std::mutex> lock(queue.m_mutex);
+		if (queue.m_jobs.empty())
+		{
+			return false;
+		}
+		job = std::move(queue.m_jobs.back());
+		queue.m_jobs.pop_back();
+		return true;
+	}
+
+	bool CJobSystem::StealJob(std::size_t queueIdx, SJob& job)
+	{
+		for (std::size_t i = 1; i < m_queues.size(); ++i)
+		{
+			SJobQueue& queue = *m_queues[(queueIdx + i) % m_queues.size()];
+			std::lock_guard<std::mutex> lock(queue.m_mutex);
+			if (!queue.m_jobs.empty())
+			{
+				job = std::move(queue.m_jobs.front());
+				queue.m_jobs.pop_front();
+				return true;
+			}
+		}
+		return false;
+	}
+
+	std::size_t CJobSystem::GetCurrentQueueIdx() const
+	{
+		return s_currentJobSystem == this ? s_currentQueueIdx : m_workers.size();
+	}
+}
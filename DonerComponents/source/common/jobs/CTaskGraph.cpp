@@ -0,0 +1,108 @@
+////////////////////////////////////////////////////////////
+//
+// MIT License
+//
+// DonerComponents
+// Copyright(c) 2017 Donerkebap13
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+#include <donercomponents/jobs/CTaskGraph.h>
+#include <donercomponents/ErrorMessages.h>
+
+namespace DonerComponents
+{
+	CTaskGraph::TTaskId CTaskGraph::AddTask(CJobSystem::TJob job)
+	{
+		m_tasks.emplace_back(std::move(job));
+		return m_tasks.size() - 1;
+	}
+
+	bool CTaskGraph::AddDependency(TTaskId task, TTaskId dependency)
+	{
+		if (task < m_tasks.size() && dependency < task)
+		{
+			m_tasks[dependency].m_successors.emplace_back(task);
+			++m_tasks[task].m_numPredecessors;
+			return true;
+		}
+		DC_ERROR_MSG(EErrorCode::InvalidTaskDependency, "Task %u can't depend on task %u", static_cast<unsigned>(task), static_cast<unsigned>(dependency));
+		return false;
+	}
+
+	void CTaskGraph::Run(CJobSystem& jobSystem)
+	{
+		// Tasks are already sorted topologically, so there's no need to track dependencies
+		if (jobSystem.GetNumWorkers() == 0)
+		{
+			for (STask& task : m_tasks)
+			{
+				task.m_job();
+			}
+			return;
+		}
+
+		if (m_pendingPredecessors.size() != m_tasks.size())
+		{
+			m_pendingPredecessors = std::vector<std::atomic<int>>(m_tasks.size());
+		}
+		for (std::size_t i = 0; i < m_tasks.size(); ++i)
+		{
+			m_pendingPredecessors[i] = m_tasks[i].m_numPredecessors;
+		}
+
+		// Every task is keyed by its id under the key of the run, whichever predecessor submits it
+		const CJobSystem::TJobKey runKey = jobSystem.GetNextJobKey();
+		std::atomic<int> remainingTasks(static_cast<int>(m_tasks.size()));
+		for (std::size_t i = 0; i < m_tasks.size(); ++i)
+		{
+			if (m_tasks[i].m_numPredecessors == 0)
+			{
+				SubmitTask(i, jobSystem, runKey, remainingTasks);
+			}
+		}
+		jobSystem.Wait(remainingTasks);
+	}
+
+	void CTaskGraph::Clear()
+	{
+		m_tasks.clear();
+		m_pendingPredecessors.clear();
+	}
+
+	void CTaskGraph::SubmitTask(TTaskId task, CJobSystem& jobSystem, const CJobSystem::TJobKey& runKey, std::atomic<int>& remainingTasks)
+	{
+		CJobSystem::TJobKey key = runKey;
+		key.emplace_back(task);
+		jobSystem.SubmitWithKey([this, task, &jobSystem, &runKey, &remainingTasks]()
+		{
+			m_tasks[task].m_job();
+			for (TTaskId successor : m_tasks[task].m_successors)
+			{
+				if (--m_pendingPredecessors[successor] == 0)
+				{
+					SubmitTask(successor, jobSystem, runKey, remainingTasks);
+				}
+			}
+			--remainingTasks;
+		}, std::move(key));
+	}
+}
@@ -0,0 +1,59 @@
+////////////////////////////////////////////////////////////
+//
+// MIT License
+//
+// DonerComponents
+// Copyright(c) 2017 Donerkebap13
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+#include <donercomponents/messages/CMsgDispatchTable.h>
+#include <donercomponents/messages/CMsgHandler.h>
+
+namespace DonerComponents
+{
+	CMsgDispatchTable::CMsgDispatchTable()
+		: m_built(false)
+	{}
+
+	CMsgDispatchTable::~CMsgDispatchTable()
+	{
+		for (CMsgHandlerBase* handler : m_handlers)
+		{
+			delete handler;
+		}
+		m_handlers.clear();
+	}
+
+	bool CMsgDispatchTable::Add(CTypeHasher::TypeIndex messageIdx, CMsgHandlerBase* handler)
+	{
+		if (messageIdx >= m_handlers.size())
+		{
+			m_handlers.resize(messageIdx + 1, nullptr);
+		}
+		else if (m_handlers[messageIdx])
+		{
+			return false;
+		}
+		m_handlers[messageIdx] = handler;
+		return true;
+	}
+}
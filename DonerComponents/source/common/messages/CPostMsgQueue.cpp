@@ -0,0 +1,226 @@
+////////////////////////////////////////////////////////////
+//
+// MIT License
+//
+// DonerComponents
+// Copyright(c) 2017 Donerkebap13
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+#include <donercomponents/messages/CPostMsgQueue.h>
+
+#include <algorithm>
+
+namespace DonerComponents
+{
+	CPostMsgQueue::CPostMsgQueue(std::size_t blockSize/* = DEFAULT_BLOCK_SIZE*/)
+		: m_head(0)
+		, m_numCoalesced(0)
+		, m_generation(1)
+		, m_coalescing(true)
+		, m_blockSize(blockSize)
+		, m_currentBlock(0)
+		, m_offset(0)
+	{}
+
+	CPostMsgQueue::~CPostMsgQueue()
+	{
+		Clear();
+		for (SBlock& block : m_blocks)
+		{
+			delete[] block.m_data;
+		}
+	}
+
+	void CPostMsgQueue::SendAll()
+	{
+		// Messages posted while sending may be pushed to this same queue
+		while (!IsEmpty())
+		{
+			SendFront(GetSize());
+		}
+	}
+
+	std::size_t CPostMsgQueue::SendFront(std::size_t maxMsgs)
+	{
+		std::size_t numSent = 0;
+		while (numSent < maxMsgs && m_head < m_postMsgs.size())
+		{
+			CPostMessageBase* postMsg = m_postMsgs[m_head];
+			postMsg->SendMessage();
+			postMsg->~CPostMessageBase();
+			++m_head;
+			++numSent;
+		}
+
+		if (IsEmpty())
+		{
+			m_postMsgs.clear();
+			m_head = 0;
+			Reset();
+		}
+		return numSent;
+	}
+
+	void CPostMsgQueue::SendAllBatched()
+	{
+		std::size_t numMsgs = GetSize();
+		m_batchEntries.clear();
+		for (std::size_t i = 0; i < numMsgs; ++i)
+		{
+			CPostMessageBase* postMsg = m_postMsgs[m_head + i];
+			m_batchEntries.push_back({ postMsg, postMsg->GetMessageIndex(), GetGameObjectKey(postMsg->GetGameObject()), i });
+		}
+		std::sort(m_batchEntries.begin(), m_batchEntries.end());
+
+		m_batchMsgs.clear();
+		for (const SBatchEntry& entry : m_batchEntries)
+		{
+			m_batchMsgs.push_back(entry.m_postMsg);
+		}
+
+		std::size_t begin = 0;
+		while (begin < numMsgs)
+		{
+			std::size_t end = begin + 1;
+			while (end < numMsgs && m_batchEntries[end].m_messageIdx == m_batchEntries[begin].m_messageIdx && m_batchEntries[end].m_gameObject == m_batchEntries[begin].m_gameObject)
+			{
+				++end;
+			}
+			m_batchMsgs[begin]->SendBatch(&m_batchMsgs[begin], end - begin);
+			begin = end;
+		}
+
+		// Messages pushed to this queue while sending go after the batches, in posting order
+		for (std::size_t i = m_head + numMsgs; i < m_postMsgs.size(); ++i)
+		{
+			m_postMsgs[i]->SendMessage();
+		}
+		Clear();
+	}
+
+	void CPostMsgQueue::MoveTo(CPostMsgQueue& other)
+	{
+		for (std::size_t i = m_head; i < m_postMsgs.size(); ++i)
+		{
+			m_postMsgs[i]->MoveTo(other);
+		}
+		Clear();
+	}
+
+	void CPostMsgQueue::MoveRangeTo(std::size_t begin, std::size_t end, CPostMsgQueue& other)
+	{
+		for (std::size_t i = m_head + begin; i < m_head + end; ++i)
+		{
+			m_postMsgs[i]->MoveTo(other);
+		}
+	}
+
+	void CPostMsgQueue::Clear()
+	{
+		for (std::size_t i = m_head; i < m_postMsgs.size(); ++i)
+		{
+			m_postMsgs[i]->~CPostMessageBase();
+		}
+		m_postMsgs.clear();
+		m_head = 0;
+		Reset();
+	}
+
+	std::size_t& CPostMsgQueue::FindCoalescedPosition(int gameObjectKey, CTypeHasher::TypeIndex messageIdx)
+	{
+		if ((m_numCoalesced + 1) * 2 > m_coalescedSlots.size())
+		{
+			std::vector<SCoalescedSlot> oldSlots(m_coalescedSlots.empty() ? 64 : m_coalescedSlots.size() * 2);
+			oldSlots.swap(m_coalescedSlots);
+			for (const SCoalescedSlot& oldSlot : oldSlots)
+			{
+				if (oldSlot.m_generation == m_generation)
+				{
+					FindCoalescedSlot(oldSlot.m_gameObject, oldSlot.m_messageIdx) = oldSlot;
+				}
+			}
+		}
+
+		SCoalescedSlot& slot = FindCoalescedSlot(gameObjectKey, messageIdx);
+		if (slot.m_generation != m_generation)
+		{
+			slot.m_gameObject = gameObjectKey;
+			slot.m_messageIdx = messageIdx;
+			slot.m_position = NO_POSITION;
+			slot.m_generation = m_generation;
+			++m_numCoalesced;
+		}
+		else if (slot.m_position != NO_POSITION && slot.m_position < m_head)
+		{
+			// Already sent messages can't be merged anymore
+			slot.m_position = NO_POSITION;
+		}
+		return slot.m_position;
+	}
+
+	CPostMsgQueue::SCoalescedSlot& CPostMsgQueue::FindCoalescedSlot(int gameObjectKey, CTypeHasher::TypeIndex messageIdx)
+	{
+		std::size_t mask = m_coalescedSlots.size() - 1;
+		std::size_t slotIdx = ((static_cast<unsigned>(gameObjectKey) * 31u + messageIdx) * 0x9E3779B1u) & mask;
+		while (m_coalescedSlots[slotIdx].m_generation == m_generation)
+		{
+			const SCoalescedSlot& slot = m_coalescedSlots[slotIdx];
+			if (slot.m_gameObject == gameObjectKey && slot.m_messageIdx == messageIdx)
+			{
+				break;
+			}
+			slotIdx = (slotIdx + 1) & mask;
+		}
+		return m_coalescedSlots[slotIdx];
+	}
+
+	void* CPostMsgQueue::Allocate(std::size_t size, std::size_t alignment)
+	{
+		while (m_currentBlock < m_blocks.size())
+		{
+			SBlock& block = m_blocks[m_currentBlock];
+			std::size_t address = reinterpret_cast<std::size_t>(block.m_data) + m_offset;
+			std::size_t padding = (alignment - address % alignment) % alignment;
+			if (m_offset + padding + size <= block.m_size)
+			{
+				m_offset += padding + size;
+				return block.m_data + m_offset - size;
+			}
+			++m_currentBlock;
+			m_offset = 0;
+		}
+
+		// Blocks from new[] are aligned for any fundamental type
+		m_blocks.emplace_back(size > m_blockSize ? size : m_blockSize);
+		m_offset = size;
+		return m_blocks.back().m_data;
+	}
+
+	void CPostMsgQueue::Reset()
+	{
+		m_currentBlock = 0;
+		m_offset = 0;
+		// Frees every coalesced slot at once
+		++m_generation;
+		m_numCoalesced = 0;
+	}
+}
@@ -0,0 +1,136 @@
+////////////////////////////////////////////////////////////
+//
+// MIT License
+//
+// DonerComponents
+// Copyright(c) 2017 Donerkebap13
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+#include <donercomponents/messages/CPostMsgTimingWheel.h>
+
+#include <cmath>
+
+namespace DonerComponents
+{
+	CPostMsgTimingWheel::CPostMsgTimingWheel(float tickDuration)
+		: m_currentOverflow(0)
+		, m_currentTick(0)
+		, m_accumulatedTime(0.0)
+		, m_tickDuration(tickDuration)
+		, m_size(0)
+	{}
+
+	void CPostMsgTimingWheel::Advance(float dt, CPostMsgQueue& queue)
+	{
+		m_accumulatedTime += dt;
+		while (m_accumulatedTime >= m_tickDuration)
+		{
+			m_accumulatedTime -= m_tickDuration;
+			Tick(queue);
+		}
+	}
+
+	void CPostMsgTimingWheel::Clear()
+	{
+		for (std::size_t level = 0; level < NUM_LEVELS; ++level)
+		{
+			for (SSlot& slot : m_slots[level])
+			{
+				slot.m_postMsgs.Clear();
+				slot.m_dueTicks.clear();
+			}
+		}
+		for (SSlot& slot : m_overflow)
+		{
+			slot.m_postMsgs.Clear();
+			slot.m_dueTicks.clear();
+		}
+		m_size = 0;
+	}
+
+	std::uint64_t CPostMsgTimingWheel::GetDueTick(float delay) const
+	{
+		double ticks = std::ceil(static_cast<double>(delay) / m_tickDuration);
+		if (!(ticks > 1.0))
+		{
+			return m_currentTick + 1;
+		}
+		if (ticks > static_cast<double>(MAX_DELAY_TICKS))
+		{
+			return m_currentTick + MAX_DELAY_TICKS;
+		}
+		return m_currentTick + static_cast<std::uint64_t>(ticks);
+	}
+
+	CPostMsgTimingWheel::SSlot& CPostMsgTimingWheel::GetSlot(std::uint64_t dueTick)
+	{
+		// The lowest level whose slots cover the distance. Its slot for dueTick is reached
+		// before dueTick and after the current tick, so it's cascaded down in time
+		std::uint64_t distance = dueTick - m_currentTick;
+		for (std::size_t level = 0; level < NUM_LEVELS; ++level)
+		{
+			if (distance < (std::uint64_t(1) << (SLOT_BITS * (level + 1))))
+			{
+				return m_slots[level][(dueTick >> (SLOT_BITS * level)) & (NUM_SLOTS - 1)];
+			}
+		}
+		return m_overflow[m_currentOverflow];
+	}
+
+	void CPostMsgTimingWheel::Tick(CPostMsgQueue& queue)
+	{
+		++m_currentTick;
+
+		if ((m_currentTick & ((std::uint64_t(1) << (SLOT_BITS * NUM_LEVELS)) - 1)) == 0)
+		{
+			SSlot& overflow = m_overflow[m_currentOverflow];
+			m_currentOverflow = 1 - m_currentOverflow;
+			Cascade(overflow);
+		}
+
+		// Each time a level wraps around, the next slot of the level above is spread over the lower levels
+		for (std::size_t level = NUM_LEVELS - 1; level > 0; --level)
+		{
+			if ((m_currentTick & ((std::uint64_t(1) << (SLOT_BITS * level)) - 1)) == 0)
+			{
+				Cascade(m_slots[level][(m_currentTick >> (SLOT_BITS * level)) & (NUM_SLOTS - 1)]);
+			}
+		}
+
+		SSlot& slot = m_slots[0][m_currentTick & (NUM_SLOTS - 1)];
+		m_size -= slot.m_dueTicks.size();
+		slot.m_postMsgs.MoveTo(queue);
+		slot.m_dueTicks.clear();
+	}
+
+	void CPostMsgTimingWheel::Cascade(SSlot& slot)
+	{
+		m_cascadedDueTicks.swap(slot.m_dueTicks);
+		slot.m_postMsgs.MoveEachTo([this](std::size_t i) -> CPostMsgQueue&
+		{
+			SSlot& newSlot = GetSlot(m_cascadedDueTicks[i]);
+			newSlot.m_dueTicks.emplace_back(m_cascadedDueTicks[i]);
+			return newSlot.m_postMsgs;
+		});
+		m_cascadedDueTicks.clear();
+	}
+}
@@ -0,0 +1,85 @@
+////////////////////////////////////////////////////////////
+//
+// MIT License
+//
+// DonerComponents
+// Copyright(c) 2017 Donerkebap13
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+#include <donercomponents/utils/CAtomicBitMask.h>
+
+namespace DonerComponents
+{
+	CAtomicBitMask::CAtomicBitMask()
+		: m_size(0)
+	{}
+
+	void CAtomicBitMask::Resize(std::size_t size)
+	{
+		m_size = size;
+		m_words = std::vector<std::atomic<std::uint64_t>>((size + 63) / 64);
+		for (std::atomic<std::uint64_t>& word : m_words)
+		{
+			word = 0;
+		}
+	}
+
+	void CAtomicBitMask::Set(std::size_t position, bool value)
+	{
+		std::uint64_t bit = std::uint64_t(1) << (position % 64);
+		if (value)
+		{
+			m_words[position / 64].fetch_or(bit, std::memory_order_relaxed);
+		}
+		else
+		{
+			m_words[position / 64].fetch_and(~bit, std::memory_order_relaxed);
+		}
+	}
+
+	bool CAtomicBitMask::Get(std::size_t position) const
+	{
+		return (m_words[position / 64].load(std::memory_order_relaxed) >> (position % 64)) & 1;
+	}
+
+	std::size_t CAtomicBitMask::GetNextSet(std::size_t begin, std::size_t end) const
+	{
+		std::size_t position = begin;
+		while (position < end)
+		{
+			std::uint64_t word = m_words[position / 64].load(std::memory_order_relaxed) >> (position % 64);
+			if (word == 0)
+			{
+				// Skips the rest of this word at once
+				position = (position / 64 + 1) * 64;
+				continue;
+			}
+			while ((word & 1) == 0)
+			{
+				word >>= 1;
+				++position;
+			}
+			return position < end ? position : end;
+		}
+		return end;
+	}
+}
@@ -0,0 +1,93 @@
+////////////////////////////////////////////////////////////
+//
+// MIT License
+//
+// DonerComponents
+// Copyright(c) 2017 Donerkebap13
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+#include <donercomponents/utils/hash/CStrIDTable.h>
+#include <donercomponents/utils/hash/hash_cstrid.h>
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace DonerComponents
+{
+	namespace
+	{
+#ifdef NDEBUG
+		std::atomic<bool> s_enabled(false);
+#else
+		std::atomic<bool> s_enabled(true);
+#endif
+
+		std::mutex& GetStringsMutex()
+		{
+			static std::mutex mutex;
+			return mutex;
+		}
+
+		std::unordered_map<CStrID, std::string>& GetStrings()
+		{
+			static std::unordered_map<CStrID, std::string> strings;
+			return strings;
+		}
+	}
+
+	void CStrIDTable::SetEnabled(bool enabled)
+	{
+		s_enabled = enabled;
+	}
+
+	bool CStrIDTable::IsEnabled()
+	{
+		return s_enabled;
+	}
+
+	CStrID CStrIDTable::Register(const char* str)
+	{
+		CStrID id(str);
+		if (s_enabled && id != CStrID())
+		{
+			std::lock_guard<std::mutex> lock(GetStringsMutex());
+			GetStrings().emplace(id, str);
+		}
+		return id;
+	}
+
+	const char* CStrIDTable::GetString(CStrID id)
+	{
+		std::lock_guard<std::mutex> lock(GetStringsMutex());
+		std::unordered_map<CStrID, std::string>& strings = GetStrings();
+		auto it = strings.find(id);
+		return it != strings.end() ? it->second.c_str() : "";
+	}
+
+	void CStrIDTable::Clear()
+	{
+		std::lock_guard<std::mutex> lock(GetStringsMutex());
+		GetStrings().clear();
+	}
+}
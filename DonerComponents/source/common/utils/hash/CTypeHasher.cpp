@@ -0,0 +1,87 @@
+////////////////////////////////////////////////////////////
+//
+// MIT License
+//
+// DonerComponents
+// Copyright(c) 2017 Donerkebap13
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+#include <donercomponents/utils/hash/CTypeHasher.h>
+
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace DonerComponents
+{
+	namespace
+	{
+		std::mutex& GetIndicesMutex()
+		{
+			static std::mutex mutex;
+			return mutex;
+		}
+
+		std::unordered_map<std::string, CTypeHasher::TypeIndex>& GetIndices()
+		{
+			static std::unordered_map<std::string, CTypeHasher::TypeIndex> indices;
+			return indices;
+		}
+
+		// "{anonymous}" for GCC, "(anonymous namespace)" for Clang and "`anonymous namespace'" for MSVC
+		bool IsInAnonymousNamespace(const char* signature)
+		{
+			return std::strstr(signature, "{anonymous}") || std::strstr(signature, "anonymous namespace");
+		}
+	}
+
+	CTypeHasher::TypeIndex CTypeHasher::GetNumIndices()
+	{
+		std::lock_guard<std::mutex> lock(GetIndicesMutex());
+		return GetIndices().size();
+	}
+
+	CTypeHasher::TypeIndex CTypeHasher::GetIndex(const char* signature, const void* localTag)
+	{
+		std::string key(signature);
+		if (IsInAnonymousNamespace(signature))
+		{
+			// Only visible from one translation unit, so its address can't differ across shared libraries
+			key += '@';
+			key += std::to_string(reinterpret_cast<std::uintptr_t>(localTag));
+		}
+
+		std::lock_guard<std::mutex> lock(GetIndicesMutex());
+		std::unordered_map<std::string, TypeIndex>& indices = GetIndices();
+		auto it = indices.find(key);
+		if (it != indices.end())
+		{
+			return it->second;
+		}
+		TypeIndex index = indices.size();
+		indices.emplace(std::move(key), index);
+		return index;
+	}
+}
@@ -28,6 +28,7 @@
 #include <donercomponents/CDonerComponentsSystems.h>
 #include <donercomponents/component/CComponent.h>
 #include <donercomponents/component/CComponentFactoryManager.h>
+#include <donercomponents/component/CComponentTraits.h>
 #include <donercomponents/handle/CHandle.h>
 
 #include <gtest/gtest.h>
@@ -37,6 +38,10 @@ namespace DonerComponents
 	namespace ComponentTestInternal
 	{
 		const int LOOP_COUNT = 5;
+		const int NUM_SLEEPERS = 130;
+		const int NUM_BUDGETED = 5;
+		const std::size_t UPDATE_BUDGET = 2;
+		const int NUM_BATCHED = 6;
 
 		class CCompFoo : public CComponent
 		{
@@ -63,6 +68,50 @@ namespace DonerComponents
 		};
         
         class CCompBar: public CComponent {};
+
+		class CCompSleeper : public CComponent
+		{
+		public:
+			CCompSleeper() : m_updateCount(0), m_lastDt(0.f) {}
+
+		protected:
+			void DoUpdate(float dt) override
+			{
+				++m_updateCount;
+				m_lastDt = dt;
+			}
+
+		public:
+			int m_updateCount;
+			float m_lastDt;
+		};
+
+		class CCompBatched : public CComponent
+		{
+		public:
+			CCompBatched() : m_updateCount(0) {}
+
+			static void UpdateBatch(CCompBatched* components, std::size_t count, float /*dt*/)
+			{
+				s_batchSizes.emplace_back(count);
+				for (std::size_t i = 0; i < count; ++i)
+				{
+					++components[i].m_updateCount;
+				}
+			}
+
+			int m_updateCount;
+
+			static std::vector<std::size_t> s_batchSizes;
+		};
+
+		std::vector<std::size_t> CCompBatched::s_batchSizes;
+
+		class CCompBatchedDerived : public CCompBatched
+		{
+		public:
+			int m_extra;
+		};
 	}
 
 	class CComponentTest : public ::testing::Test
@@ -369,4 +418,161 @@ namespace DonerComponents
         
         delete component;
     }
+
+	TEST_F(CComponentTest, component_without_doUpdate_is_not_updatable)
+	{
+		EXPECT_TRUE(CComponentTraits::HasUpdate<ComponentTestInternal::CCompFoo>());
+		EXPECT_TRUE(CComponentTraits::HasUpdate<ComponentTestInternal::CCompSleeper>());
+		EXPECT_FALSE(CComponentTraits::HasUpdate<ComponentTestInternal::CCompBar>());
+	}
+
+	TEST_F(CComponentTest, sleeping_component_not_updated)
+	{
+		ComponentTestInternal::CCompFoo* component = static_cast<ComponentTestInternal::CCompFoo*>(
+			m_componentFactoryManager->CreateComponent<ComponentTestInternal::CCompFoo>());
+		component->Init();
+		component->Activate();
+
+		component->Sleep();
+		EXPECT_TRUE(component->IsSleeping());
+		m_componentFactoryManager->Update(0.f);
+		EXPECT_EQ(0, component->m_updateCount);
+
+		component->WakeUp();
+		EXPECT_FALSE(component->IsSleeping());
+		m_componentFactoryManager->Update(0.f);
+		EXPECT_EQ(1, component->m_updateCount);
+	}
+
+	TEST_F(CComponentTest, reused_component_slot_is_awake)
+	{
+		CComponent* component = m_componentFactoryManager->CreateComponent<ComponentTestInternal::CCompFoo>();
+		component->Sleep();
+		EXPECT_TRUE(m_componentFactoryManager->DestroyComponent(&component));
+
+		ComponentTestInternal::CCompFoo* newComponent = static_cast<ComponentTestInternal::CCompFoo*>(
+			m_componentFactoryManager->CreateComponent<ComponentTestInternal::CCompFoo>());
+		newComponent->Init();
+		newComponent->Activate();
+		EXPECT_FALSE(newComponent->IsSleeping());
+		m_componentFactoryManager->Update(0.f);
+		EXPECT_EQ(1, newComponent->m_updateCount);
+	}
+
+	TEST_F(CComponentTest, only_awake_components_updated)
+	{
+		ADD_COMPONENT_FACTORY("sleeper", ComponentTestInternal::CCompSleeper, ComponentTestInternal::NUM_SLEEPERS);
+
+		std::vector<ComponentTestInternal::CCompSleeper*> components;
+		for (int i = 0; i < ComponentTestInternal::NUM_SLEEPERS; ++i)
+		{
+			ComponentTestInternal::CCompSleeper* component = static_cast<ComponentTestInternal::CCompSleeper*>(
+				m_componentFactoryManager->CreateComponent<ComponentTestInternal::CCompSleeper>());
+			component->Init();
+			component->Activate();
+			if (i % 3 != 0)
+			{
+				component->Sleep();
+			}
+			components.emplace_back(component);
+		}
+
+		m_componentFactoryManager->Update(0.f);
+		for (int i = 0; i < ComponentTestInternal::NUM_SLEEPERS; ++i)
+		{
+			EXPECT_EQ(i % 3 == 0 ? 1 : 0, components[i]->m_updateCount);
+		}
+	}
+
+	TEST_F(CComponentTest, budgeted_update_round_robins_components)
+	{
+		ADD_COMPONENT_FACTORY("sleeper", ComponentTestInternal::CCompSleeper, ComponentTestInternal::NUM_BUDGETED);
+		m_componentFactoryManager->SetUpdateBudget<ComponentTestInternal::CCompSleeper>(ComponentTestInternal::UPDATE_BUDGET);
+
+		std::vector<ComponentTestInternal::CCompSleeper*> components;
+		for (int i = 0; i < ComponentTestInternal::NUM_BUDGETED; ++i)
+		{
+			ComponentTestInternal::CCompSleeper* component = static_cast<ComponentTestInternal::CCompSleeper*>(
+				m_componentFactoryManager->CreateComponent<ComponentTestInternal::CCompSleeper>());
+			component->Init();
+			component->Activate();
+			components.emplace_back(component);
+		}
+
+		m_componentFactoryManager->Update(1.f);
+		EXPECT_EQ(1, components[0]->m_updateCount);
+		EXPECT_EQ(1, components[1]->m_updateCount);
+		EXPECT_EQ(0, components[2]->m_updateCount);
+		EXPECT_FLOAT_EQ(1.f, components[0]->m_lastDt);
+
+		m_componentFactoryManager->Update(1.f);
+		EXPECT_EQ(1, components[2]->m_updateCount);
+		EXPECT_EQ(1, components[3]->m_updateCount);
+		EXPECT_FLOAT_EQ(2.f, components[3]->m_lastDt);
+
+		m_componentFactoryManager->Update(1.f);
+		EXPECT_EQ(1, components[4]->m_updateCount);
+		EXPECT_FLOAT_EQ(3.f, components[4]->m_lastDt);
+		EXPECT_EQ(2, components[0]->m_updateCount);
+		EXPECT_FLOAT_EQ(2.f, components[0]->m_lastDt);
+		EXPECT_EQ(1, components[1]->m_updateCount);
+	}
+
+	TEST_F(CComponentTest, time_budgeted_update_updates_each_component_once_per_update)
+	{
+		ADD_COMPONENT_FACTORY("sleeper", ComponentTestInternal::CCompSleeper, ComponentTestInternal::NUM_BUDGETED);
+		m_componentFactoryManager->SetUpdateBudget<ComponentTestInternal::CCompSleeper>(0, std::chrono::seconds(10));
+
+		std::vector<ComponentTestInternal::CCompSleeper*> components;
+		for (int i = 0; i < ComponentTestInternal::NUM_BUDGETED; ++i)
+		{
+			ComponentTestInternal::CCompSleeper* component = static_cast<ComponentTestInternal::CCompSleeper*>(
+				m_componentFactoryManager->CreateComponent<ComponentTestInternal::CCompSleeper>());
+			component->Init();
+			component->Activate();
+			components.emplace_back(component);
+		}
+		components[2]->Sleep();
+
+		for (int i = 1; i <= ComponentTestInternal::LOOP_COUNT; ++i)
+		{
+			m_componentFactoryManager->Update(1.f);
+			for (int j = 0; j < ComponentTestInternal::NUM_BUDGETED; ++j)
+			{
+				EXPECT_EQ(j == 2 ? 0 : i, components[j]->m_updateCount);
+			}
+		}
+	}
+
+	TEST_F(CComponentTest, update_batch_called_with_contiguous_active_components)
+	{
+		EXPECT_TRUE(CComponentTraits::HasUpdateBatch<ComponentTestInternal::CCompBatched>());
+		EXPECT_TRUE(CComponentTraits::HasUpdate<ComponentTestInternal::CCompBatched>());
+		EXPECT_FALSE(CComponentTraits::HasUpdateBatch<ComponentTestInternal::CCompFoo>());
+		EXPECT_FALSE(CComponentTraits::HasUpdateBatch<ComponentTestInternal::CCompBatchedDerived>());
+
+		ADD_COMPONENT_FACTORY("batched", ComponentTestInternal::CCompBatched, ComponentTestInternal::NUM_BATCHED);
+
+		std::vector<ComponentTestInternal::CCompBatched*> components;
+		for (int i = 0; i < ComponentTestInternal::NUM_BATCHED; ++i)
+		{
+			ComponentTestInternal::CCompBatched* component = static_cast<ComponentTestInternal::CCompBatched*>(
+				m_componentFactoryManager->CreateComponent<ComponentTestInternal::CCompBatched>());
+			component->Init();
+			component->Activate();
+			components.emplace_back(component);
+		}
+		components[2]->Deactivate();
+		components[4]->Sleep();
+
+		ComponentTestInternal::CCompBatched::s_batchSizes.clear();
+		m_componentFactoryManager->Update(0.f);
+
+		std::vector<std::size_t> expectedBatchSizes = { 2, 1, 1 };
+		EXPECT_EQ(expectedBatchSizes, ComponentTestInternal::CCompBatched::s_batchSizes);
+		for (int i = 0; i < ComponentTestInternal::NUM_BATCHED; ++i)
+		{
+			EXPECT_EQ(i == 2 || i == 4 ? 0 : 1, components[i]->m_updateCount);
+		}
+	}
 }
@@ -0,0 +1,278 @@
+////////////////////////////////////////////////////////////
+//
+// MIT License
+//
+// DonerComponents
+// Copyright(c) 2017 Donerkebap13
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+#include <donercomponents/CDonerComponentsSystems.h>
+#include <donercomponents/component/CComponent.h>
+#include <donercomponents/component/CComponentFactoryManager.h>
+#include <donercomponents/gameObject/CGameObject.h>
+#include <donercomponents/gameObject/CFlatHierarchy.h>
+#include <donercomponents/tags/CTagsManager.h>
+#include <donercomponents/handle/CHandle.h>
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace DonerComponents
+{
+	namespace FlatHierarchyTestInternal
+	{
+		const CStrID TAG1("test");
+
+		std::vector<CGameObject*> GetOrder(const CFlatHierarchy* flatHierarchy)
+		{
+			std::vector<CGameObject*> order;
+			for (std::size_t i = 0; i < flatHierarchy->GetSize(); ++i)
+			{
+				if (CGameObject* gameObject = flatHierarchy->GetAt(i))
+				{
+					order.emplace_back(gameObject);
+				}
+			}
+			return order;
+		}
+
+		class CCompInitCounter : public CComponent
+		{
+		public:
+			CCompInitCounter() : m_initCount(0) {}
+
+			void DoInit() override { ++m_initCount; }
+
+			int m_initCount;
+		};
+
+		// Adds a child to its owner while being initialized
+		class CCompChildSpawner : public CComponent
+		{
+		public:
+			void DoInit() override
+			{
+				CGameObject* owner = GetOwner();
+				owner->AddChild(CDonerComponentsSystems::Get()->GetGameObjectManager()->CreateGameObject());
+			}
+		};
+	}
+
+	class CFlatHierarchyTest : public ::testing::Test
+	{
+	public:
+		CFlatHierarchyTest()
+			: m_gameObjectManager(nullptr)
+		{
+			CDonerComponentsSystems& systems = CDonerComponentsSystems::CreateInstance()->Init();
+			m_gameObjectManager = systems.GetGameObjectManager();
+			systems.GetTagsManager()->RegisterTag(FlatHierarchyTestInternal::TAG1);
+			ADD_COMPONENT_FACTORY("initCounter", FlatHierarchyTestInternal::CCompInitCounter, 4);
+			ADD_COMPONENT_FACTORY("childSpawner", FlatHierarchyTestInternal::CCompChildSpawner, 4);
+			m_gameObjectManager->SetFlatHierarchyEnabled(true);
+		}
+
+		~CFlatHierarchyTest()
+		{
+			CDonerComponentsSystems::DestroyInstance();
+		}
+
+		CGameObjectManager *m_gameObjectManager;
+	};
+
+	TEST_F(CFlatHierarchyTest, children_follow_their_parent_in_depth_first_order)
+	{
+		CGameObject* root = m_gameObjectManager->CreateGameObject();
+		CGameObject* child1 = m_gameObjectManager->CreateGameObject();
+		CGameObject* child2 = m_gameObjectManager->CreateGameObject();
+		CGameObject* child11 = m_gameObjectManager->CreateGameObject();
+		root->AddChild(child1);
+		root->AddChild(child2);
+		child1->AddChild(child11);
+
+		std::vector<CGameObject*> expected = { root, child1, child11, child2 };
+		EXPECT_EQ(expected, FlatHierarchyTestInternal::GetOrder(m_gameObjectManager->GetFlatHierarchy()));
+		EXPECT_EQ(4, m_gameObjectManager->GetFlatHierarchy()->GetSubtreeSize(0));
+		EXPECT_EQ(2, m_gameObjectManager->GetFlatHierarchy()->GetSubtreeSize(1));
+	}
+
+	TEST_F(CFlatHierarchyTest, reparenting_moves_the_whole_subtree)
+	{
+		CGameObject* root = m_gameObjectManager->CreateGameObject();
+		CGameObject* child1 = m_gameObjectManager->CreateGameObject();
+		CGameObject* child2 = m_gameObjectManager->CreateGameObject();
+		CGameObject* child11 = m_gameObjectManager->CreateGameObject();
+		root->AddChild(child1);
+		root->AddChild(child2);
+		child1->AddChild(child11);
+
+		child2->AddChild(child1);
+		std::vector<CGameObject*> expected = { root, child2, child1, child11 };
+		EXPECT_EQ(expected, FlatHierarchyTestInternal::GetOrder(m_gameObjectManager->GetFlatHierarchy()));
+		EXPECT_EQ(4, m_gameObjectManager->GetFlatHierarchy()->GetSubtreeSize(0));
+		EXPECT_EQ(3, m_gameObjectManager->GetFlatHierarchy()->GetSubtreeSize(1));
+
+		root->RemoveChild(child2);
+		expected = { root, child2, child1, child11 };
+		EXPECT_EQ(expected, FlatHierarchyTestInternal::GetOrder(m_gameObjectManager->GetFlatHierarchy()));
+		EXPECT_EQ(1, m_gameObjectManager->GetFlatHierarchy()->GetSubtreeSize(0));
+		EXPECT_EQ(3, m_gameObjectManager->GetFlatHierarchy()->GetSubtreeSize(1));
+	}
+
+	TEST_F(CFlatHierarchyTest, adding_children_in_bulk_moves_their_subtrees)
+	{
+		CGameObject* root1 = m_gameObjectManager->CreateGameObject();
+		CGameObject* root2 = m_gameObjectManager->CreateGameObject();
+		CGameObject* child1 = m_gameObjectManager->CreateGameObject();
+		CGameObject* child2 = m_gameObjectManager->CreateGameObject();
+		CGameObject* child11 = m_gameObjectManager->CreateGameObject();
+		root1->AddChild(child1);
+		root1->AddChild(child2);
+		child1->AddChild(child11);
+
+		EXPECT_EQ(2, root2->AddChildren({ child2, child1 }));
+		std::vector<CGameObject*> expected = { root1, root2, child2, child1, child11 };
+		EXPECT_EQ(expected, FlatHierarchyTestInternal::GetOrder(m_gameObjectManager->GetFlatHierarchy()));
+		EXPECT_EQ(1, m_gameObjectManager->GetFlatHierarchy()->GetSubtreeSize(0));
+		EXPECT_EQ(4, m_gameObjectManager->GetFlatHierarchy()->GetSubtreeSize(1));
+	}
+
+	TEST_F(CFlatHierarchyTest, enabling_it_picks_up_existing_hierarchies)
+	{
+		m_gameObjectManager->SetFlatHierarchyEnabled(false);
+		EXPECT_EQ(nullptr, m_gameObjectManager->GetFlatHierarchy());
+
+		CGameObject* root = m_gameObjectManager->CreateGameObject();
+		CGameObject* child1 = m_gameObjectManager->CreateGameObject();
+		CGameObject* child2 = m_gameObjectManager->CreateGameObject();
+		CGameObject* child11 = m_gameObjectManager->CreateGameObject();
+		root->AddChild(child1);
+		root->AddChild(child2);
+		child1->AddChild(child11);
+
+		m_gameObjectManager->SetFlatHierarchyEnabled(true);
+		std::vector<CGameObject*> expected = { root, child1, child11, child2 };
+		EXPECT_EQ(expected, FlatHierarchyTestInternal::GetOrder(m_gameObjectManager->GetFlatHierarchy()));
+		EXPECT_EQ(4, m_gameObjectManager->GetFlatHierarchy()->GetSubtreeSize(0));
+	}
+
+	TEST_F(CFlatHierarchyTest, activation_stops_at_inactive_children)
+	{
+		CGameObject* root = m_gameObjectManager->CreateGameObject();
+		CGameObject* child1 = m_gameObjectManager->CreateGameObject();
+		CGameObject* child11 = m_gameObjectManager->CreateGameObject();
+		CGameObject* child2 = m_gameObjectManager->CreateGameObject();
+		root->AddChild(child1);
+		child1->AddChild(child11);
+		root->AddChild(child2);
+		child1->SetIsInitiallyActive(false);
+
+		root->Init();
+		EXPECT_TRUE(child11->IsInitialized());
+		root->CheckFirstActivation();
+		EXPECT_TRUE(root->IsActive());
+		EXPECT_FALSE(child1->IsActive());
+		EXPECT_FALSE(child11->IsActive());
+		EXPECT_TRUE(child2->IsActive());
+
+		child1->Activate();
+		EXPECT_TRUE(child1->IsActive());
+		EXPECT_TRUE(child11->IsActive());
+
+		root->Deactivate();
+		EXPECT_FALSE(root->IsActive());
+		EXPECT_FALSE(child1->IsActive());
+		EXPECT_FALSE(child11->IsActive());
+		EXPECT_FALSE(child2->IsActive());
+
+		root->Activate();
+		EXPECT_TRUE(child11->IsActive());
+		EXPECT_TRUE(child2->IsActive());
+	}
+
+	TEST_F(CFlatHierarchyTest, recursive_tag_queries_return_depth_first_order)
+	{
+		CGameObject* root = m_gameObjectManager->CreateGameObject();
+		CGameObject* child1 = m_gameObjectManager->CreateGameObject();
+		CGameObject* child2 = m_gameObjectManager->CreateGameObject();
+		CGameObject* child11 = m_gameObjectManager->CreateGameObject();
+		root->AddChild(child1);
+		root->AddChild(child2);
+		child1->AddChild(child11);
+		root->AddTags(FlatHierarchyTestInternal::TAG1);
+		child2->AddTags(FlatHierarchyTestInternal::TAG1);
+		child11->AddTags(FlatHierarchyTestInternal::TAG1);
+
+		std::vector<CHandle> children = root->GetChildrenWithTagsRecursive(FlatHierarchyTestInternal::TAG1);
+		ASSERT_EQ(2, children.size());
+		EXPECT_EQ(CHandle(child11), children[0]);
+		EXPECT_EQ(CHandle(child2), children[1]);
+	}
+
+	TEST_F(CFlatHierarchyTest, destroyed_subtrees_are_compacted_away)
+	{
+		CGameObject* root = m_gameObjectManager->CreateGameObject();
+		CGameObject* child1 = m_gameObjectManager->CreateGameObject();
+		CGameObject* child11 = m_gameObjectManager->CreateGameObject();
+		CGameObject* child2 = m_gameObjectManager->CreateGameObject();
+		root->AddChild(child1);
+		child1->AddChild(child11);
+		root->AddChild(child2);
+
+		child1->Destroy();
+		m_gameObjectManager->ExecuteScheduledDestroys();
+
+		const CFlatHierarchy* flatHierarchy = m_gameObjectManager->GetFlatHierarchy();
+		EXPECT_EQ(0, flatHierarchy->GetNumHoles());
+		std::vector<CGameObject*> expected = { root, child2 };
+		EXPECT_EQ(expected, FlatHierarchyTestInternal::GetOrder(flatHierarchy));
+		EXPECT_EQ(2, flatHierarchy->GetSize());
+		EXPECT_EQ(2, flatHierarchy->GetSubtreeSize(0));
+
+		CGameObject* child3 = m_gameObjectManager->CreateGameObject();
+		root->AddChild(child3);
+		expected = { root, child2, child3 };
+		EXPECT_EQ(expected, FlatHierarchyTestInternal::GetOrder(flatHierarchy));
+	}
+
+	TEST_F(CFlatHierarchyTest, init_visits_every_game_object_when_a_component_adds_children)
+	{
+		CGameObject* root = m_gameObjectManager->CreateGameObject();
+		CGameObject* child1 = m_gameObjectManager->CreateGameObject();
+		CGameObject* child2 = m_gameObjectManager->CreateGameObject();
+		root->AddChild(child1);
+		root->AddChild(child2);
+		child1->AddComponent<FlatHierarchyTestInternal::CCompChildSpawner>();
+		FlatHierarchyTestInternal::CCompInitCounter* counter = child2->AddComponent<FlatHierarchyTestInternal::CCompInitCounter>();
+
+		root->Init();
+		EXPECT_TRUE(child2->IsInitialized());
+		EXPECT_EQ(1, counter->m_initCount);
+		ASSERT_EQ(1, child1->GetChildrenCount());
+		CGameObject* spawned = child1->GetChildByIndex(0);
+		EXPECT_TRUE(spawned->IsInitialized());
+
+		std::vector<CGameObject*> expected = { root, child1, spawned, child2 };
+		EXPECT_EQ(expected, FlatHierarchyTestInternal::GetOrder(m_gameObjectManager->GetFlatHierarchy()));
+	}
+}
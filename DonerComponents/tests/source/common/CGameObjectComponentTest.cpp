@@ -317,6 +317,19 @@ namespace DonerComponents
 		EXPECT_FALSE(static_cast<bool>(compHandle));
 	}
 
+	TEST_F(CGameObjectComponentTest, removed_component_skips_its_scheduled_destroy)
+	{
+		CGameObject* gameObject = m_gameObjectManager->CreateGameObject();
+		CComponent* component = gameObject->AddComponent<GameObjectComponentTestInternal::CCompFoo>();
+		component->Destroy();
+		EXPECT_TRUE(gameObject->RemoveComponent<GameObjectComponentTestInternal::CCompFoo>());
+
+		// Reuses the freed slot, which must survive the destroy scheduled for the old component
+		CHandle compHandle = gameObject->AddComponent<GameObjectComponentTestInternal::CCompFoo>();
+		m_componentFactoryManager->ExecuteScheduledDestroys();
+		EXPECT_TRUE(static_cast<bool>(compHandle));
+	}
+
 	TEST_F(CGameObjectComponentTest, activate_gameObject_activates_components)
 	{
 		CGameObject* gameObject = m_gameObjectManager->CreateGameObject();
@@ -359,6 +372,69 @@ namespace DonerComponents
 		EXPECT_TRUE(component11->IsActive());
 	}
 
+	TEST_F(CGameObjectComponentTest, deferred_activation_delivers_callbacks_on_execute)
+	{
+		CGameObject* gameObject, *gameObject1, *gameObject11 = nullptr;
+		CComponent* component, *component1, *component11 = nullptr;
+		std::tie(gameObject, gameObject1, gameObject11, component, component1, component11) = GetGameObjectWithChildrenRecursive();
+
+		m_gameObjectManager->SetDeferredActivationEnabled(true);
+		gameObject->Init();
+		gameObject->Activate();
+		EXPECT_EQ(1, m_gameObjectManager->GetPendingActivationsCount());
+		EXPECT_TRUE(gameObject->IsActive());
+		EXPECT_TRUE(gameObject11->IsActive());
+		EXPECT_FALSE(component->IsActive());
+		EXPECT_FALSE(component11->IsActive());
+
+		m_gameObjectManager->ExecutePendingActivations();
+		EXPECT_EQ(0, m_gameObjectManager->GetPendingActivationsCount());
+		EXPECT_TRUE(component->IsActive());
+		EXPECT_TRUE(component11->IsActive());
+
+		gameObject1->Deactivate();
+		EXPECT_TRUE(gameObject->IsActive());
+		EXPECT_FALSE(gameObject1->IsActive());
+		EXPECT_FALSE(gameObject11->IsActive());
+		EXPECT_TRUE(component1->IsActive());
+
+		CDonerComponentsSystems::Get()->Update(0.f);
+		EXPECT_TRUE(component->IsActive());
+		EXPECT_FALSE(component1->IsActive());
+		EXPECT_FALSE(component11->IsActive());
+		EXPECT_FALSE(gameObject1->IsActive());
+	}
+
+	TEST_F(CGameObjectComponentTest, deferred_activation_budget_carries_calls_over)
+	{
+		CGameObject* gameObject, *gameObject1, *gameObject11 = nullptr;
+		CComponent* component, *component1, *component11 = nullptr;
+		std::tie(gameObject, gameObject1, gameObject11, component, component1, component11) = GetGameObjectWithChildrenRecursive();
+
+		m_gameObjectManager->SetDeferredActivationEnabled(true);
+		m_gameObjectManager->SetActivationBudget(1);
+		gameObject->Init();
+		gameObject->Activate();
+		gameObject1->Deactivate();
+		EXPECT_FALSE(gameObject11->IsActive());
+
+		CDonerComponentsSystems::Get()->Update(0.f);
+		EXPECT_EQ(1, m_gameObjectManager->GetPendingActivationsCount());
+		EXPECT_TRUE(component->IsActive());
+		EXPECT_TRUE(component1->IsActive());
+		EXPECT_TRUE(component11->IsActive());
+		EXPECT_FALSE(gameObject1->IsActive());
+		EXPECT_FALSE(gameObject11->IsActive());
+
+		CDonerComponentsSystems::Get()->Update(0.f);
+		EXPECT_EQ(0, m_gameObjectManager->GetPendingActivationsCount());
+		EXPECT_TRUE(component->IsActive());
+		EXPECT_FALSE(component1->IsActive());
+		EXPECT_FALSE(component11->IsActive());
+		EXPECT_TRUE(gameObject->IsActive());
+		EXPECT_FALSE(gameObject11->IsActive());
+	}
+
 	TEST_F(CGameObjectComponentTest, deactivate_gameObject_deactivates_components)
 	{
 		CGameObject* gameObject = m_gameObjectManager->CreateGameObject();
@@ -33,6 +33,9 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <vector>
+
 namespace DonerComponents
 {
 	class CGameObjectManagerTest : public ::testing::Test
@@ -61,4 +64,112 @@ namespace DonerComponents
 		CGameObject* gameObject = m_gameObjectManager->CreateGameObject();
 		EXPECT_NE(nullptr, gameObject);
 	}
+
+	TEST_F(CGameObjectManagerTest, get_gameObjects_by_name)
+	{
+		for (bool nameIndexEnabled : { false, true })
+		{
+			m_gameObjectManager->SetNameIndexEnabled(nameIndexEnabled);
+
+			CGameObject* player = m_gameObjectManager->CreateGameObject();
+			CGameObject* enemy1 = m_gameObjectManager->CreateGameObject();
+			CGameObject* enemy2 = m_gameObjectManager->CreateGameObject();
+			player->SetName("Player");
+			enemy1->SetName("Enemy");
+			enemy2->SetName("Enemy");
+
+			EXPECT_EQ(CHandle(player), m_gameObjectManager->GetGameObjectByName(CStrID("Player")));
+			EXPECT_EQ(2, m_gameObjectManager->GetGameObjectsByName(CStrID("Enemy")).size());
+			EXPECT_FALSE(static_cast<bool>(m_gameObjectManager->GetGameObjectByName(CStrID("Camera"))));
+
+			enemy1->SetName("Camera");
+			EXPECT_EQ(CHandle(enemy1), m_gameObjectManager->GetGameObjectByName(CStrID("Camera")));
+			EXPECT_EQ(CHandle(enemy2), m_gameObjectManager->GetGameObjectByName(CStrID("Enemy")));
+
+			player->Destroy();
+			enemy1->Destroy();
+			enemy2->Destroy();
+			EXPECT_FALSE(static_cast<bool>(m_gameObjectManager->GetGameObjectByName(CStrID("Player"))));
+			EXPECT_TRUE(m_gameObjectManager->GetGameObjectsByName(CStrID("Enemy")).empty());
+			m_gameObjectManager->ExecuteScheduledDestroys();
+		}
+	}
+
+	TEST_F(CGameObjectManagerTest, name_index_keeps_the_other_gameObjects_when_one_is_removed)
+	{
+		m_gameObjectManager->SetNameIndexEnabled(true);
+		CGameObject* enemy1 = m_gameObjectManager->CreateGameObject();
+		CGameObject* enemy2 = m_gameObjectManager->CreateGameObject();
+		CGameObject* enemy3 = m_gameObjectManager->CreateGameObject();
+		enemy1->SetName("Enemy");
+		enemy2->SetName("Enemy");
+		enemy3->SetName("Enemy");
+
+		enemy1->SetName("Camera");
+		std::vector<CHandle> enemies = m_gameObjectManager->GetGameObjectsByName(CStrID("Enemy"));
+		ASSERT_EQ(2, enemies.size());
+		EXPECT_NE(enemies.end(), std::find(enemies.begin(), enemies.end(), CHandle(enemy2)));
+		EXPECT_NE(enemies.end(), std::find(enemies.begin(), enemies.end(), CHandle(enemy3)));
+
+		enemy3->Destroy();
+		EXPECT_EQ(CHandle(enemy2), m_gameObjectManager->GetGameObjectByName(CStrID("Enemy")));
+		enemy2->Destroy();
+		EXPECT_FALSE(static_cast<bool>(m_gameObjectManager->GetGameObjectByName(CStrID("Enemy"))));
+		EXPECT_EQ(CHandle(enemy1), m_gameObjectManager->GetGameObjectByName(CStrID("Camera")));
+	}
+
+	TEST_F(CGameObjectManagerTest, enabling_name_index_picks_up_existing_gameObjects)
+	{
+		CGameObject* parent = m_gameObjectManager->CreateGameObject();
+		CGameObject* child = m_gameObjectManager->CreateGameObject();
+		parent->SetName("Parent");
+		child->SetName("Child");
+		parent->AddChild(child);
+
+		m_gameObjectManager->SetNameIndexEnabled(true);
+		EXPECT_TRUE(m_gameObjectManager->IsNameIndexEnabled());
+		EXPECT_EQ(CHandle(child), m_gameObjectManager->GetGameObjectByName(CStrID("Child")));
+
+		parent->Destroy();
+		EXPECT_FALSE(static_cast<bool>(m_gameObjectManager->GetGameObjectByName(CStrID("Child"))));
+	}
+
+	TEST_F(CGameObjectManagerTest, scheduled_destroys_free_every_gameObject_once)
+	{
+		const std::size_t numGameObjects = 3000;
+		std::vector<CHandle> handles;
+		for (std::size_t i = 0; i < numGameObjects; ++i)
+		{
+			handles.emplace_back(m_gameObjectManager->CreateGameObject());
+		}
+
+		// Destroyed in reverse, and twice, so the pool order and the deduplication are what matter
+		for (auto it = handles.rbegin(); it != handles.rend(); ++it)
+		{
+			CGameObject* gameObject = *it;
+			gameObject->Destroy();
+			gameObject->Destroy();
+		}
+		for (CHandle& handle : handles)
+		{
+			EXPECT_TRUE(static_cast<bool>(handle));
+		}
+
+		m_gameObjectManager->ExecuteScheduledDestroys();
+		for (CHandle& handle : handles)
+		{
+			EXPECT_FALSE(static_cast<bool>(handle));
+		}
+
+		std::vector<CHandle> newHandles;
+		for (std::size_t i = 0; i < numGameObjects; ++i)
+		{
+			newHandles.emplace_back(m_gameObjectManager->CreateGameObject());
+		}
+		m_gameObjectManager->ExecuteScheduledDestroys();
+		for (CHandle& handle : newHandles)
+		{
+			EXPECT_TRUE(static_cast<bool>(handle));
+		}
+	}
 }
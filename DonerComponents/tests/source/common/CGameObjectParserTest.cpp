@@ -39,6 +39,9 @@
 
 #include <gtest/gtest.h>
 
+#include <cstdio>
+#include <vector>
+
 namespace GameObjectParserTestInternal
 {
 	class CCompFoo : public DonerComponents::CComponent
@@ -152,7 +155,7 @@ namespace DonerComponents
 		CGameObjectParser parser;
 		CGameObject* gameObject = parser.ParseSceneFromJson(::GameObjectParserTestInternal::ONE_LEVEL_GAME_OBJECT);
 		EXPECT_NE(nullptr, gameObject);
-		EXPECT_EQ(std::string("test1"), gameObject->GetName());
+		EXPECT_EQ(CStrID("test1"), gameObject->GetName());
 		EXPECT_TRUE(gameObject->GetIsInitiallyActive());
 		EXPECT_TRUE(gameObject->IsInitialized());
 		EXPECT_TRUE(gameObject->IsActive());
@@ -163,7 +166,7 @@ namespace DonerComponents
 	{
 		CGameObjectParser parser;
 		CGameObject* gameObject = parser.ParseSceneFromJson(::GameObjectParserTestInternal::ONE_LEVEL_GAME_OBJECT_INITIALLY_DISABLED);
-		EXPECT_EQ(std::string("test1"), gameObject->GetName());
+		EXPECT_EQ(CStrID("test1"), gameObject->GetName());
 		EXPECT_FALSE(gameObject->GetIsInitiallyActive());
 		EXPECT_TRUE(gameObject->IsInitialized());
 		EXPECT_FALSE(gameObject->IsActive());
@@ -227,7 +230,7 @@ namespace DonerComponents
 		EXPECT_EQ(1, gameObject->GetChildrenCount());
 		CGameObject* child1 = gameObject->GetChildByName("test11");
 
-		EXPECT_EQ(std::string("test11"), child1->GetName());
+		EXPECT_EQ(CStrID("test11"), child1->GetName());
 		EXPECT_TRUE(child1->GetIsInitiallyActive());
 		EXPECT_TRUE(child1->IsInitialized());
 		EXPECT_TRUE(child1->IsActive());
@@ -270,7 +273,7 @@ namespace DonerComponents
 		parser.ParsePrefabFromJson(::GameObjectParserTestInternal::BASIC_PREFAB);
 
 		CGameObject* gameObject = parser.ParseSceneFromJson(::GameObjectParserTestInternal::GAME_OBJECT_BASED_ON_PREFAB);
-		EXPECT_EQ(std::string("test1"), gameObject->GetName());
+		EXPECT_EQ(CStrID("test1"), gameObject->GetName());
 		EXPECT_TRUE(gameObject->GetIsInitiallyActive());
 		EXPECT_TRUE(gameObject->IsInitialized());
 		EXPECT_TRUE(gameObject->IsActive());
@@ -323,7 +326,7 @@ namespace DonerComponents
 		parser.ParsePrefabFromJson(::GameObjectParserTestInternal::BASIC_PREFAB);
 
 		CGameObject* gameObject = parser.ParseSceneFromJson(::GameObjectParserTestInternal::GAME_OBJECT_BASED_ON_PREFAB);
-		EXPECT_EQ(std::string("test1"), gameObject->GetName());
+		EXPECT_EQ(CStrID("test1"), gameObject->GetName());
 		EXPECT_TRUE(gameObject->GetIsInitiallyActive());
 		EXPECT_TRUE(gameObject->IsInitialized());
 		EXPECT_TRUE(gameObject->IsActive());
@@ -350,7 +353,7 @@ namespace DonerComponents
 		CGameObjectParser parser;
 		CGameObject* gameObject = parser.ParseSceneFromMemory(mdp.GetBaseData(), mdp.GetSize());
 
-		EXPECT_EQ(std::string("test1"), gameObject->GetName());
+		EXPECT_EQ(CStrID("test1"), gameObject->GetName());
 		EXPECT_TRUE(gameObject->GetIsInitiallyActive());
 		EXPECT_TRUE(gameObject->IsInitialized());
 		EXPECT_TRUE(gameObject->IsActive());
@@ -380,4 +383,69 @@ namespace DonerComponents
 
 		EXPECT_EQ(1337, component->m_a);
 	}
+
+	TEST_F(CGameObjectParserTest, prefabs_are_not_found_by_name)
+	{
+		CGameObjectParser parser;
+		parser.ParsePrefabFromJson(::GameObjectParserTestInternal::TWO_LEVEL_PREFAB);
+		CGameObject* gameObject = parser.ParseSceneFromJson(::GameObjectParserTestInternal::GAME_OBJECT_BASED_ON_TWO_LEVEL_PREFAB);
+		CHandle gameObject1 = gameObject->GetChildByName("test11");
+
+		for (bool nameIndexEnabled : { false, true })
+		{
+			m_gameObjectManager->SetNameIndexEnabled(nameIndexEnabled);
+			EXPECT_FALSE(static_cast<bool>(m_gameObjectManager->GetGameObjectByName(CStrID("2levelPrefab"))));
+			std::vector<CHandle> gameObjects = m_gameObjectManager->GetGameObjectsByName(CStrID("test11"));
+			ASSERT_EQ(1, gameObjects.size());
+			EXPECT_EQ(gameObject1, gameObjects[0]);
+		}
+	}
+
+	TEST_F(CGameObjectParserTest, parse_gameObject_from_file_async)
+	{
+		const char* const path = "async_scene_test.json";
+		FILE* file = fopen(path, "wb");
+		ASSERT_NE(nullptr, file);
+		fputs(::GameObjectParserTestInternal::ONE_LEVEL_GAME_OBJECT, file);
+		fclose(file);
+
+		CHandle result;
+		bool callbackCalled = false;
+		CGameObjectParser parser;
+		parser.ParseSceneFromFileAsync(path, [&result, &callbackCalled](CHandle handle)
+		{
+			result = handle;
+			callbackCalled = true;
+		});
+		EXPECT_FALSE(callbackCalled);
+
+		CDonerComponentsSystems::Get()->Update(0.f);
+		remove(path);
+
+		EXPECT_TRUE(callbackCalled);
+		CGameObject* gameObject = result;
+		ASSERT_NE(nullptr, gameObject);
+		EXPECT_EQ(CStrID("test1"), gameObject->GetName());
+		EXPECT_TRUE(gameObject->IsInitialized());
+		EXPECT_TRUE(gameObject->IsActive());
+		::GameObjectParserTestInternal::CCompFoo* component = gameObject->GetComponent<::GameObjectParserTestInternal::CCompFoo>();
+		EXPECT_NE(nullptr, component);
+	}
+
+	TEST_F(CGameObjectParserTest, parse_gameObject_from_invalid_file_async)
+	{
+		CHandle result;
+		bool callbackCalled = false;
+		CGameObjectParser parser;
+		parser.ParseSceneFromFileAsync("invalid_path.json", [&result, &callbackCalled](CHandle handle)
+		{
+			result = handle;
+			callbackCalled = true;
+		});
+
+		CDonerComponentsSystems::Get()->Update(0.f);
+
+		EXPECT_TRUE(callbackCalled);
+		EXPECT_FALSE(static_cast<bool>(result));
+	}
 }
@@ -32,6 +32,9 @@
 
 #include <gtest/gtest.h>
 
+#include <string>
+#include <vector>
+
 namespace DonerComponents
 {
 	namespace GameObjectTestInternal
@@ -96,12 +99,28 @@ namespace DonerComponents
 
 	TEST_F(CGameObjectTest, gameObject_set_name)
 	{
+		bool enabled = CStrIDTable::IsEnabled();
+		CStrIDTable::SetEnabled(true);
 		CGameObject* gameObject = m_gameObjectManager->CreateGameObject();
 		static const std::string gameObjectName("TestName");
 		gameObject->SetName(gameObjectName.c_str());
-		const std::string& name = gameObject->GetName();
+		CStrIDTable::SetEnabled(enabled);
+		CStrID name = gameObject->GetName();
+
+		EXPECT_EQ(CStrID(gameObjectName.c_str()), name);
+		EXPECT_EQ(gameObjectName, CStrIDTable::GetString(name));
+	}
+
+	TEST_F(CGameObjectTest, gameObject_set_name_without_string_table)
+	{
+		bool enabled = CStrIDTable::IsEnabled();
+		CStrIDTable::SetEnabled(false);
+		CGameObject* gameObject = m_gameObjectManager->CreateGameObject();
+		gameObject->SetName(std::string("NotRegisteredName"));
+		CStrIDTable::SetEnabled(enabled);
 
-		EXPECT_EQ(name, gameObjectName);
+		EXPECT_EQ(CStrID("NotRegisteredName"), gameObject->GetName());
+		EXPECT_EQ(std::string(), CStrIDTable::GetString(gameObject->GetName()));
 	}
 
 	TEST_F(CGameObjectTest, gameObject_created_uninitalized_and_deactivated)
@@ -203,6 +222,73 @@ namespace DonerComponents
 		EXPECT_FALSE(success);
 	}
 
+	TEST_F(CGameObjectTest, gameObject_remove_children_keeps_the_order_of_the_rest)
+	{
+		CGameObject* parent = m_gameObjectManager->CreateGameObject();
+		std::vector<CHandle> children;
+		for (int i = 0; i < 1000; ++i)
+		{
+			CHandle child = m_gameObjectManager->CreateGameObject();
+			EXPECT_TRUE(parent->AddChild(child));
+			children.emplace_back(child);
+		}
+		EXPECT_EQ(1000, parent->GetChildrenCount());
+
+		for (std::size_t i = 0; i < children.size(); i += 2)
+		{
+			EXPECT_TRUE(parent->RemoveChild(children[i]));
+			EXPECT_FALSE(parent->HasChild(children[i]));
+			EXPECT_TRUE(parent->HasChild(children[i + 1]));
+		}
+		EXPECT_EQ(500, parent->GetChildrenCount());
+
+		for (int i = 0; i < parent->GetChildrenCount(); ++i)
+		{
+			EXPECT_EQ(children[i * 2 + 1], parent->GetChildByIndex(i));
+		}
+
+		CGameObject* newParent = m_gameObjectManager->CreateGameObject();
+		EXPECT_TRUE(newParent->AddChild(children[1]));
+		EXPECT_FALSE(parent->HasChild(children[1]));
+		EXPECT_TRUE(newParent->HasChild(children[1]));
+		EXPECT_EQ(499, parent->GetChildrenCount());
+		EXPECT_EQ(children[3], parent->GetChildByIndex(0));
+	}
+
+	TEST_F(CGameObjectTest, gameObject_add_children_moves_them_from_their_parents)
+	{
+		CGameObject* oldParent = m_gameObjectManager->CreateGameObject();
+		CGameObject* newParent = m_gameObjectManager->CreateGameObject();
+		CHandle existingChild = m_gameObjectManager->CreateGameObject();
+		newParent->AddChild(existingChild);
+
+		std::vector<CHandle> children;
+		for (int i = 0; i < 500; ++i)
+		{
+			CHandle child = m_gameObjectManager->CreateGameObject();
+			if (i % 2 == 0)
+			{
+				oldParent->AddChild(child);
+			}
+			children.emplace_back(child);
+		}
+		children.emplace_back(existingChild);
+		children.emplace_back(newParent);
+		children.emplace_back(CHandle());
+
+		EXPECT_EQ(500, newParent->AddChildren(children));
+		EXPECT_EQ(0, oldParent->GetChildrenCount());
+		EXPECT_EQ(501, newParent->GetChildrenCount());
+		EXPECT_EQ(existingChild, newParent->GetChildByIndex(0));
+		for (int i = 0; i < 500; ++i)
+		{
+			CGameObject* child = children[i];
+			EXPECT_EQ(CHandle(newParent), child->GetParent());
+			EXPECT_EQ(children[i], newParent->GetChildByIndex(i + 1));
+			EXPECT_FALSE(oldParent->HasChild(children[i]));
+		}
+	}
+
 	TEST_F(CGameObjectTest, get_children_by_name)
 	{
 		static const char* const CHILD_NAME("Test");
@@ -218,7 +304,7 @@ namespace DonerComponents
 		CHandle childHandle = parent->GetChildByName(CHILD_NAME);
 		EXPECT_TRUE(static_cast<bool>(childHandle));
 		child = childHandle;
-		EXPECT_EQ(child->GetName(), std::string(CHILD_NAME));
+		EXPECT_EQ(CStrID(CHILD_NAME), child->GetName());
 	}
 
 	TEST_F(CGameObjectTest, get_children_by_invalid_name_return_invalid_handle)
@@ -238,6 +324,59 @@ namespace DonerComponents
 		EXPECT_FALSE(static_cast<bool>(childHandle));
 	}
 
+	TEST_F(CGameObjectTest, get_children_by_name_with_many_children)
+	{
+		CGameObject* parent = m_gameObjectManager->CreateGameObject();
+		std::vector<CGameObject*> children;
+		for (int i = 0; i < 32; ++i)
+		{
+			CGameObject* child = m_gameObjectManager->CreateGameObject();
+			child->SetName("child" + std::to_string(i));
+			EXPECT_TRUE(parent->AddChild(child));
+			children.emplace_back(child);
+		}
+
+		EXPECT_EQ(CHandle(children[20]), parent->GetChildByName(CStrID("child20")));
+		EXPECT_EQ(CHandle(children[3]), parent->GetChildByName(std::string("child3")));
+		EXPECT_FALSE(static_cast<bool>(parent->GetChildByName("child32")));
+
+		CGameObject* lastChild = m_gameObjectManager->CreateGameObject();
+		lastChild->SetName("child32");
+		parent->AddChild(lastChild);
+		EXPECT_EQ(CHandle(lastChild), parent->GetChildByName("child32"));
+
+		children[20]->SetName("renamed");
+		EXPECT_FALSE(static_cast<bool>(parent->GetChildByName("child20")));
+		EXPECT_EQ(CHandle(children[20]), parent->GetChildByName("renamed"));
+
+		children[5]->SetName("child6");
+		EXPECT_EQ(CHandle(children[5]), parent->GetChildByName("child6"));
+		parent->RemoveChild(children[5]);
+		EXPECT_EQ(CHandle(children[6]), parent->GetChildByName("child6"));
+	}
+
+	TEST_F(CGameObjectTest, get_children_by_name_checks_the_text_with_the_string_table)
+	{
+		// Both names have the same hash
+		static const std::string CHILD_NAME("child58694");
+		static const std::string COLLIDING_NAME("child113927");
+		ASSERT_EQ(CStrID(CHILD_NAME.c_str()), CStrID(COLLIDING_NAME.c_str()));
+
+		bool enabled = CStrIDTable::IsEnabled();
+		CStrIDTable::SetEnabled(true);
+		CGameObject* parent = m_gameObjectManager->CreateGameObject();
+		CGameObject* child = m_gameObjectManager->CreateGameObject();
+		child->SetName(CHILD_NAME);
+		parent->AddChild(child);
+
+		EXPECT_EQ(CHandle(child), parent->GetChildByName(CHILD_NAME));
+		EXPECT_FALSE(static_cast<bool>(parent->GetChildByName(COLLIDING_NAME)));
+
+		CStrIDTable::SetEnabled(false);
+		EXPECT_EQ(CHandle(child), parent->GetChildByName(COLLIDING_NAME));
+		CStrIDTable::SetEnabled(enabled);
+	}
+
 	TEST_F(CGameObjectTest, get_children_by_index)
 	{
 		static const char* const CHILD_NAME("Test");
@@ -253,7 +392,7 @@ namespace DonerComponents
 		CHandle childHandle = parent->GetChildByIndex(0);
 		EXPECT_TRUE(static_cast<bool>(childHandle));
 		child = childHandle;
-		EXPECT_EQ(child->GetName(), std::string(CHILD_NAME));
+		EXPECT_EQ(CStrID(CHILD_NAME), child->GetName());
 	}
 
 	TEST_F(CGameObjectTest, get_children_by_invalid_index_return_invalid_handle)
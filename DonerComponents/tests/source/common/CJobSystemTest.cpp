@@ -0,0 +1,196 @@
+////////////////////////////////////////////////////////////
+//
+// MIT License
+//
+// DonerComponents
+// Copyright(c) 2017 Donerkebap13
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+#include <donercomponents/jobs/CJobSystem.h>
+#include <donercomponents/jobs/CTaskGraph.h>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace DonerComponents
+{
+	namespace JobSystemTestInternal
+	{
+		const std::size_t NUM_WORKERS = 4;
+		const std::size_t NUM_JOBS = 1000;
+		const int NUM_TASKS = 8;
+		const int NUM_RUNS = 100;
+	}
+
+	class CJobSystemTest : public ::testing::Test
+	{
+	public:
+		CJobSystemTest()
+			: m_jobSystem(JobSystemTestInternal::NUM_WORKERS)
+		{
+		}
+
+		CJobSystem m_jobSystem;
+	};
+
+	TEST_F(CJobSystemTest, parallel_for_runs_every_index_once)
+	{
+		std::vector<std::atomic<int>> counters(JobSystemTestInternal::NUM_JOBS);
+		m_jobSystem.ParallelFor(JobSystemTestInternal::NUM_JOBS, [&counters](std::size_t i)
+		{
+			++counters[i];
+		});
+
+		for (std::atomic<int>& counter : counters)
+		{
+			EXPECT_EQ(1, counter.load());
+		}
+	}
+
+	TEST_F(CJobSystemTest, submitted_jobs_are_executed)
+	{
+		std::atomic<int> pending(static_cast<int>(JobSystemTestInternal::NUM_JOBS));
+		for (std::size_t i = 0; i < JobSystemTestInternal::NUM_JOBS; ++i)
+		{
+			m_jobSystem.Submit([&pending]() { --pending; });
+		}
+		m_jobSystem.Wait(pending);
+		EXPECT_EQ(0, pending.load());
+	}
+
+	TEST_F(CJobSystemTest, continuation_runs_after_job)
+	{
+		std::atomic<int> pending(1);
+		std::atomic<bool> jobDone(false);
+		bool jobDoneBeforeContinuation = false;
+		m_jobSystem.Submit([&jobDone]() { jobDone = true; }, [&]()
+		{
+			jobDoneBeforeContinuation = jobDone;
+			--pending;
+		});
+		m_jobSystem.Wait(pending);
+		EXPECT_TRUE(jobDoneBeforeContinuation);
+	}
+
+	TEST_F(CJobSystemTest, main_thread_jobs_wait_for_execute)
+	{
+		std::atomic<int> pending(1);
+		int executed = 0;
+		m_jobSystem.Submit([&]()
+		{
+			m_jobSystem.SubmitToMainThread([&executed]() { ++executed; });
+			--pending;
+		});
+		m_jobSystem.Wait(pending);
+		EXPECT_EQ(0, executed);
+
+		m_jobSystem.ExecuteMainThreadJobs();
+		EXPECT_EQ(1, executed);
+	}
+
+	TEST_F(CJobSystemTest, jobs_run_inline_without_workers)
+	{
+		CJobSystem jobSystem(0);
+		int executed = 0;
+		jobSystem.Submit([&executed]() { ++executed; });
+		EXPECT_EQ(1, executed);
+	}
+
+	TEST_F(CJobSystemTest, task_graph_respects_dependencies)
+	{
+		std::mutex mutex;
+		std::vector<int> order;
+		CTaskGraph graph;
+		for (int i = 0; i < JobSystemTestInternal::NUM_TASKS; ++i)
+		{
+			graph.AddTask([i, &mutex, &order]()
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				order.push_back(i);
+			});
+		}
+		// Chain of even tasks, odd tasks are free
+		for (int i = 2; i < JobSystemTestInternal::NUM_TASKS; i += 2)
+		{
+			EXPECT_TRUE(graph.AddDependency(i, i - 2));
+		}
+
+		for (int run = 0; run < 2; ++run)
+		{
+			order.clear();
+			graph.Run(m_jobSystem);
+			ASSERT_EQ(static_cast<std::size_t>(JobSystemTestInternal::NUM_TASKS), order.size());
+
+			int lastEven = -2;
+			for (int task : order)
+			{
+				if (task % 2 == 0)
+				{
+					EXPECT_EQ(lastEven + 2, task);
+					lastEven = task;
+				}
+			}
+		}
+	}
+
+	TEST_F(CJobSystemTest, task_graph_keys_tasks_by_id)
+	{
+		std::vector<CJobSystem::TJobKey> keys(JobSystemTestInternal::NUM_TASKS);
+		CTaskGraph graph;
+		for (int i = 0; i < JobSystemTestInternal::NUM_TASKS; ++i)
+		{
+			graph.AddTask([i, &keys]()
+			{
+				keys[i] = CJobSystem::GetCurrentJobContext()->m_key;
+			});
+		}
+		// Last task waits for all the others, so any of them may be the one submitting it
+		for (int i = 0; i < JobSystemTestInternal::NUM_TASKS - 1; ++i)
+		{
+			EXPECT_TRUE(graph.AddDependency(JobSystemTestInternal::NUM_TASKS - 1, i));
+		}
+
+		for (int run = 0; run < JobSystemTestInternal::NUM_RUNS; ++run)
+		{
+			graph.Run(m_jobSystem);
+			for (int i = 0; i < JobSystemTestInternal::NUM_TASKS; ++i)
+			{
+				ASSERT_EQ(2u, keys[i].size());
+				EXPECT_EQ(keys[0][0], keys[i][0]);
+				EXPECT_EQ(static_cast<std::uint64_t>(i), keys[i][1]);
+			}
+		}
+	}
+
+	TEST_F(CJobSystemTest, task_graph_rejects_dependency_on_later_task)
+	{
+		CTaskGraph graph;
+		CTaskGraph::TTaskId first = graph.AddTask([]() {});
+		CTaskGraph::TTaskId second = graph.AddTask([]() {});
+		EXPECT_FALSE(graph.AddDependency(first, second));
+		EXPECT_FALSE(graph.AddDependency(first, first));
+		EXPECT_TRUE(graph.AddDependency(second, first));
+	}
+}
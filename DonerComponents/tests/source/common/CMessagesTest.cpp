@@ -88,6 +88,7 @@ namespace DonerComponents
 
 			void RegisterMessages() override
 			{
+				++s_registerMessagesCount;
 				RegisterMessage(&CCompBar::OnTestMessage);
 				RegisterMessage(&CCompBar::OnTestMessage2);
 			}
@@ -103,7 +104,44 @@ namespace DonerComponents
 			}
 
 			int m_bar;
+
+			static int s_registerMessagesCount;
 		};
+
+		int CCompBar::s_registerMessagesCount = 0;
+
+		class CCompOrder : public CComponent
+		{
+		public:
+			CCompOrder() : m_id(0) {}
+
+			void RegisterMessages() override
+			{
+				RegisterMessage(&CCompOrder::OnTestMessage);
+				RegisterMessage(&CCompOrder::OnTestMessage2);
+			}
+
+			void OnTestMessage(const STestMessage& /*message*/)
+			{
+				s_order.emplace_back(m_id);
+				// A recursive send from a handler uses the same scratch stack
+				if (m_id == 1)
+				{
+					m_owner.SendMessage(STestMessage2(), ESendMessageType::Recursive);
+				}
+			}
+
+			void OnTestMessage2(const STestMessage2& /*message*/)
+			{
+				s_order.emplace_back(m_id * 10);
+			}
+
+			int m_id;
+
+			static std::vector<int> s_order;
+		};
+
+		std::vector<int> CCompOrder::s_order;
 	}
 
 	class CMessagesTest : public ::testing::Test
@@ -119,6 +157,7 @@ namespace DonerComponents
 
 			ADD_COMPONENT_FACTORY("foo", MessagesTestInternal::CCompFoo, 2);
 			ADD_COMPONENT_FACTORY("bar", MessagesTestInternal::CCompBar, 2);
+			ADD_COMPONENT_FACTORY("order", MessagesTestInternal::CCompOrder, 8);
 		}
 
 		~CMessagesTest()
@@ -356,6 +395,50 @@ namespace DonerComponents
 		EXPECT_EQ(MessagesTestInternal::TEST_VALUE, compFoo->m_foo);
 	}
 
+	TEST_F(CMessagesTest, SendMessage_recursive_visits_hierarchy_depth_first)
+	{
+		// 0 -> (1 -> (2, 3), 4 -> 5)
+		const int parents[] = { -1, 0, 1, 1, 0, 4 };
+		std::vector<CGameObject*> gameObjects;
+		for (int i = 0; i < 6; ++i)
+		{
+			CGameObject* gameObject = m_gameObjectManager->CreateGameObject();
+			MessagesTestInternal::CCompOrder* compOrder = gameObject->AddComponent<MessagesTestInternal::CCompOrder>();
+			compOrder->m_id = i;
+			if (parents[i] >= 0)
+			{
+				gameObjects[parents[i]]->AddChild(gameObject);
+			}
+			gameObjects.emplace_back(gameObject);
+		}
+		gameObjects[0]->Init();
+		gameObjects[0]->Activate();
+
+		MessagesTestInternal::CCompOrder::s_order.clear();
+		gameObjects[0]->SendMessage(MessagesTestInternal::STestMessage(0), ESendMessageType::Recursive);
+		std::vector<int> expected = { 0, 1, 10, 20, 30, 2, 3, 4, 5 };
+		EXPECT_EQ(expected, MessagesTestInternal::CCompOrder::s_order);
+	}
+
+	TEST_F(CMessagesTest, SendMessage_recursive_reaches_the_bottom_of_deep_hierarchies)
+	{
+		const int depth = 2000;
+		CGameObject* root = m_gameObjectManager->CreateGameObject();
+		CGameObject* parent = root;
+		for (int i = 0; i < depth; ++i)
+		{
+			CGameObject* child = m_gameObjectManager->CreateGameObject();
+			parent->AddChild(child);
+			parent = child;
+		}
+		MessagesTestInternal::CCompFoo* compFoo = parent->AddComponent<MessagesTestInternal::CCompFoo>();
+		root->Init();
+		root->Activate();
+
+		root->SendMessage(MessagesTestInternal::STestMessage(MessagesTestInternal::TEST_VALUE), ESendMessageType::Recursive);
+		EXPECT_EQ(MessagesTestInternal::TEST_VALUE, compFoo->m_foo);
+	}
+
 	TEST_F(CMessagesTest, inactive_child_doesnt_receives_message)
 	{
 		CGameObject* gameObject = m_gameObjectManager->CreateGameObject();
@@ -417,6 +500,26 @@ namespace DonerComponents
 		EXPECT_EQ(MessagesTestInternal::TEST_VALUE * 2, compBar->m_bar);
 	}
 
+	TEST_F(CMessagesTest, BroadcastMessage_only_reaches_live_components_registered_to_the_message)
+	{
+		CGameObject* gameObject = m_gameObjectManager->CreateGameObject();
+		CGameObject* gameObject2 = m_gameObjectManager->CreateGameObject();
+		MessagesTestInternal::CCompFoo* compFoo = gameObject->AddComponent<MessagesTestInternal::CCompFoo>();
+		MessagesTestInternal::CCompBar* compBar = gameObject->AddComponent<MessagesTestInternal::CCompBar>();
+		MessagesTestInternal::CCompBar* compBar2 = gameObject2->AddComponent<MessagesTestInternal::CCompBar>();
+
+		gameObject->Init();
+		gameObject->Activate();
+		gameObject2->Init();
+		gameObject2->Activate();
+		gameObject2->Destroy();
+
+		m_gameObjectManager->BroadcastMessage(MessagesTestInternal::STestMessage2());
+		EXPECT_EQ(0, compFoo->m_foo);
+		EXPECT_EQ(1337, compBar->m_bar);
+		EXPECT_EQ(0, compBar2->m_bar);
+	}
+
 	TEST_F(CMessagesTest, gameObject_with_component_receives_postMessage)
 	{
 		CGameObject* gameObject = m_gameObjectManager->CreateGameObject();
@@ -693,4 +796,24 @@ namespace DonerComponents
 			EXPECT_EQ(i, compFoo->m_foo);
 		}
 	}
+
+	TEST_F(CMessagesTest, registered_messages_shared_by_components_of_same_type)
+	{
+		MessagesTestInternal::CCompBar::s_registerMessagesCount = 0;
+		MessagesTestInternal::CCompBar* compBar1 = static_cast<MessagesTestInternal::CCompBar*>(
+			m_componentFactoryManager->CreateComponent<MessagesTestInternal::CCompBar>());
+		MessagesTestInternal::CCompBar* compBar2 = static_cast<MessagesTestInternal::CCompBar*>(
+			m_componentFactoryManager->CreateComponent<MessagesTestInternal::CCompBar>());
+
+		compBar1->Init();
+		compBar1->Activate();
+		compBar2->Init();
+		compBar2->Activate();
+		EXPECT_EQ(1, MessagesTestInternal::CCompBar::s_registerMessagesCount);
+
+		compBar1->SendMessage(MessagesTestInternal::STestMessage2());
+		compBar2->SendMessage(MessagesTestInternal::STestMessage(MessagesTestInternal::TEST_VALUE));
+		EXPECT_EQ(1337, compBar1->m_bar);
+		EXPECT_EQ(MessagesTestInternal::TEST_VALUE, compBar2->m_bar);
+	}
 }
@@ -0,0 +1,606 @@
+////////////////////////////////////////////////////////////
+//
+// MIT License
+//
+// DonerComponents
+// Copyright(c) 2017 Donerkebap13
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+#include <donercomponents/CDonerComponentsSystems.h>
+#include <donercomponents/component/CComponent.h>
+#include <donercomponents/component/CComponentFactoryManager.h>
+#include <donercomponents/gameObject/CGameObject.h>
+#include <donercomponents/handle/CHandle.h>
+#include <donercomponents/jobs/CCommandBuffer.h>
+#include <donercomponents/jobs/CJobSystem.h>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace DonerComponents
+{
+	namespace ParallelUpdateTestInternal
+	{
+		const int LOOP_COUNT = 10;
+		const int NUM_WORKERS = 4;
+		const int NUM_GAME_OBJECTS = 32;
+		const int NUM_CHUNKED_COMPONENTS = 200;
+		const std::size_t CHUNK_SIZE = 16;
+
+		std::atomic<int> s_updateSequence(0);
+
+		struct SOrderMessage
+		{
+			SOrderMessage(int sender) : m_sender(sender) {}
+			int m_sender;
+		};
+
+		struct SCoalescedOrderMessage
+		{
+			SCoalescedOrderMessage(int sender) : m_sender(sender) {}
+			int m_sender;
+		};
+
+		// Coalesced by subtraction, so the result depends on the order messages are combined in
+		struct SCoalescedSubtractMessage
+		{
+			SCoalescedSubtractMessage(int value) : m_value(value) {}
+			int m_value;
+		};
+
+		class CCompWriter : public CComponent
+		{
+		public:
+			CCompWriter() : m_updateCount(0), m_lastSequence(0) {}
+
+			void DoUpdate(float /*dt*/) override
+			{
+				++m_updateCount;
+				m_lastSequence = ++s_updateSequence;
+			}
+
+			int m_updateCount;
+			int m_lastSequence;
+		};
+
+		class CCompReader : public CComponent
+		{
+		public:
+			CCompReader() : m_updateCount(0), m_lastSequence(0) {}
+
+			void DoUpdate(float /*dt*/) override
+			{
+				++m_updateCount;
+				m_lastSequence = ++s_updateSequence;
+			}
+
+			int m_updateCount;
+			int m_lastSequence;
+		};
+
+		class CCompPosterA : public CComponent
+		{
+		public:
+			void DoUpdate(float /*dt*/) override { m_owner.PostMessage(SOrderMessage(0)); }
+		};
+
+		class CCompPosterB : public CComponent
+		{
+		public:
+			void DoUpdate(float /*dt*/) override { m_owner.PostMessage(SOrderMessage(1)); }
+		};
+
+		class CCompReceiver : public CComponent
+		{
+		public:
+			void RegisterMessages() override
+			{
+				RegisterMessage(&CCompReceiver::OnOrderMessage);
+				RegisterMessage(&CCompReceiver::OnCoalescedOrderMessage);
+				RegisterMessage(&CCompReceiver::OnCoalescedSubtractMessage);
+			}
+
+			void OnOrderMessage(const SOrderMessage& message)
+			{
+				m_senders.emplace_back(message.m_sender);
+			}
+
+			void OnCoalescedOrderMessage(const SCoalescedOrderMessage& message)
+			{
+				m_senders.emplace_back(message.m_sender);
+			}
+
+			void OnCoalescedSubtractMessage(const SCoalescedSubtractMessage& message)
+			{
+				m_senders.emplace_back(message.m_value);
+			}
+
+			std::vector<int> m_senders;
+		};
+
+		class CCompChunked : public CComponent
+		{
+		public:
+			CCompChunked() : m_updateCount(0), m_id(0) {}
+
+			void DoUpdate(float /*dt*/) override
+			{
+				++m_updateCount;
+				s_receiver.PostMessage(SOrderMessage(m_id));
+			}
+
+			int m_updateCount;
+			int m_id;
+
+			static CHandle s_receiver;
+		};
+
+		CHandle CCompChunked::s_receiver;
+
+		class CCompSelfDestroyer : public CComponent
+		{
+		public:
+			void DoUpdate(float /*dt*/) override { m_owner.Destroy(); }
+		};
+
+		std::atomic<int> s_removerDestroys(0);
+
+		class CCompSelfRemover : public CComponent
+		{
+		public:
+			void DoUpdate(float /*dt*/) override
+			{
+				CGameObject* owner = m_owner;
+				owner->RemoveComponent<CCompSelfRemover>();
+			}
+			void DoDestroy() override { ++s_removerDestroys; }
+		};
+
+		std::thread::id s_mainThreadId;
+		std::atomic<int> s_workerDestructions(0);
+
+		struct SDestructionTracker
+		{
+			~SDestructionTracker()
+			{
+				if (std::this_thread::get_id() != s_mainThreadId)
+				{
+					++s_workerDestructions;
+				}
+			}
+		};
+
+		template<int Id>
+		class CCompDestructionTracker : public CComponent
+		{
+			SDestructionTracker m_tracker;
+		};
+	}
+}
+
+namespace DonerComponents
+{
+	template<>
+	struct SPostMsgCoalescer<ParallelUpdateTestInternal::SCoalescedSubtractMessage>
+	{
+		static void Coalesce(ParallelUpdateTestInternal::SCoalescedSubtractMessage& pending, const ParallelUpdateTestInternal::SCoalescedSubtractMessage& incoming)
+		{
+			pending.m_value -= incoming.m_value;
+		}
+	};
+}
+
+DONER_DECLARE_POST_MESSAGE_AS_COALESCED(DonerComponents::ParallelUpdateTestInternal::SCoalescedOrderMessage)
+DONER_DECLARE_POST_MESSAGE_AS_COALESCED(DonerComponents::ParallelUpdateTestInternal::SCoalescedSubtractMessage)
+
+namespace DonerComponents
+{
+	class CParallelUpdateTest : public ::testing::Test
+	{
+	public:
+		CParallelUpdateTest()
+			: m_gameObjectManager(nullptr)
+		{
+			m_gameObjectManager = CDonerComponentsSystems::CreateInstance()->Init(ParallelUpdateTestInternal::NUM_WORKERS).GetGameObjectManager();
+
+			ADD_COMPONENT_FACTORY_WITH_DEPENDENCIES("writer", ParallelUpdateTestInternal::CCompWriter, ParallelUpdateTestInternal::NUM_GAME_OBJECTS, CComponentDependencies());
+			ADD_COMPONENT_FACTORY_WITH_DEPENDENCIES("reader", ParallelUpdateTestInternal::CCompReader, ParallelUpdateTestInternal::NUM_GAME_OBJECTS, CComponentDependencies().Reads<ParallelUpdateTestInternal::CCompWriter>());
+			ADD_COMPONENT_FACTORY_WITH_DEPENDENCIES("posterA", ParallelUpdateTestInternal::CCompPosterA, ParallelUpdateTestInternal::NUM_GAME_OBJECTS, CComponentDependencies());
+			ADD_COMPONENT_FACTORY_WITH_DEPENDENCIES("posterB", ParallelUpdateTestInternal::CCompPosterB, ParallelUpdateTestInternal::NUM_GAME_OBJECTS, CComponentDependencies());
+			ADD_COMPONENT_FACTORY_WITH_DEPENDENCIES("receiver", ParallelUpdateTestInternal::CCompReceiver, ParallelUpdateTestInternal::NUM_GAME_OBJECTS, CComponentDependencies());
+			ADD_COMPONENT_FACTORY_WITH_DEPENDENCIES("destroyer", ParallelUpdateTestInternal::CCompSelfDestroyer, ParallelUpdateTestInternal::NUM_GAME_OBJECTS, CComponentDependencies());
+			ADD_COMPONENT_FACTORY_WITH_DEPENDENCIES("remover", ParallelUpdateTestInternal::CCompSelfRemover, ParallelUpdateTestInternal::NUM_GAME_OBJECTS, CComponentDependencies());
+			ADD_COMPONENT_FACTORY_WITH_DEPENDENCIES("chunked", ParallelUpdateTestInternal::CCompChunked, ParallelUpdateTestInternal::NUM_CHUNKED_COMPONENTS, CComponentDependencies());
+			ADD_COMPONENT_FACTORY_WITH_DEPENDENCIES("trackerA", ParallelUpdateTestInternal::CCompDestructionTracker<0>, ParallelUpdateTestInternal::NUM_GAME_OBJECTS, CComponentDependencies());
+			ADD_COMPONENT_FACTORY_WITH_DEPENDENCIES("trackerB", ParallelUpdateTestInternal::CCompDestructionTracker<1>, ParallelUpdateTestInternal::NUM_GAME_OBJECTS, CComponentDependencies());
+
+			CDonerComponentsSystems::Get()->GetComponentFactoryManager()->SetUpdateChunkSize<ParallelUpdateTestInternal::CCompChunked>(ParallelUpdateTestInternal::CHUNK_SIZE);
+			CDonerComponentsSystems::Get()->GetComponentFactoryManager()->SetUpdateChunkSize<ParallelUpdateTestInternal::CCompSelfDestroyer>(ParallelUpdateTestInternal::CHUNK_SIZE);
+		}
+
+		~CParallelUpdateTest()
+		{
+			CDonerComponentsSystems::DestroyInstance();
+		}
+
+		template<typename T>
+		std::vector<T*> CreateGameObjectsWithComponent(int amount)
+		{
+			std::vector<T*> components;
+			for (int i = 0; i < amount; ++i)
+			{
+				CGameObject* gameObject = m_gameObjectManager->CreateGameObject();
+				components.emplace_back(static_cast<T*>(gameObject->AddComponent<T>()));
+				gameObject->Init();
+				gameObject->Activate();
+			}
+			return components;
+		}
+
+		CGameObjectManager* m_gameObjectManager;
+	};
+
+	TEST_F(CParallelUpdateTest, job_system_created_with_requested_workers)
+	{
+		CJobSystem* jobSystem = CDonerComponentsSystems::Get()->GetJobSystem();
+		EXPECT_NE(nullptr, jobSystem);
+		EXPECT_EQ(static_cast<std::size_t>(ParallelUpdateTestInternal::NUM_WORKERS), jobSystem->GetNumWorkers());
+	}
+
+	TEST_F(CParallelUpdateTest, all_components_updated_in_parallel)
+	{
+		std::vector<ParallelUpdateTestInternal::CCompWriter*> writers = CreateGameObjectsWithComponent<ParallelUpdateTestInternal::CCompWriter>(ParallelUpdateTestInternal::NUM_GAME_OBJECTS);
+		std::vector<ParallelUpdateTestInternal::CCompReader*> readers = CreateGameObjectsWithComponent<ParallelUpdateTestInternal::CCompReader>(ParallelUpdateTestInternal::NUM_GAME_OBJECTS);
+
+		for (int i = 0; i < ParallelUpdateTestInternal::LOOP_COUNT; ++i)
+		{
+			CDonerComponentsSystems::Get()->Update(0.f);
+		}
+
+		for (ParallelUpdateTestInternal::CCompWriter* writer : writers)
+		{
+			EXPECT_EQ(ParallelUpdateTestInternal::LOOP_COUNT, writer->m_updateCount);
+		}
+		for (ParallelUpdateTestInternal::CCompReader* reader : readers)
+		{
+			EXPECT_EQ(ParallelUpdateTestInternal::LOOP_COUNT, reader->m_updateCount);
+		}
+	}
+
+	TEST_F(CParallelUpdateTest, reader_factory_updated_after_writer_factory)
+	{
+		std::vector<ParallelUpdateTestInternal::CCompWriter*> writers = CreateGameObjectsWithComponent<ParallelUpdateTestInternal::CCompWriter>(ParallelUpdateTestInternal::NUM_GAME_OBJECTS);
+		std::vector<ParallelUpdateTestInternal::CCompReader*> readers = CreateGameObjectsWithComponent<ParallelUpdateTestInternal::CCompReader>(ParallelUpdateTestInternal::NUM_GAME_OBJECTS);
+
+		for (int i = 0; i < ParallelUpdateTestInternal::LOOP_COUNT; ++i)
+		{
+			CDonerComponentsSystems::Get()->Update(0.f);
+
+			int lastWriterSequence = 0;
+			for (ParallelUpdateTestInternal::CCompWriter* writer : writers)
+			{
+				lastWriterSequence = std::max(lastWriterSequence, writer->m_lastSequence);
+			}
+			for (ParallelUpdateTestInternal::CCompReader* reader : readers)
+			{
+				EXPECT_LT(lastWriterSequence, reader->m_lastSequence);
+			}
+		}
+	}
+
+	TEST_F(CParallelUpdateTest, post_messages_from_parallel_update_keep_registration_order)
+	{
+		CGameObject* gameObject = m_gameObjectManager->CreateGameObject();
+		gameObject->AddComponent<ParallelUpdateTestInternal::CCompPosterB>();
+		gameObject->AddComponent<ParallelUpdateTestInternal::CCompPosterA>();
+		ParallelUpdateTestInternal::CCompReceiver* receiver = gameObject->AddComponent<ParallelUpdateTestInternal::CCompReceiver>();
+		gameObject->Init();
+		gameObject->Activate();
+
+		for (int i = 0; i < ParallelUpdateTestInternal::LOOP_COUNT; ++i)
+		{
+			CDonerComponentsSystems::Get()->Update(0.f);
+		}
+
+		ASSERT_EQ(static_cast<std::size_t>(2 * ParallelUpdateTestInternal::LOOP_COUNT), receiver->m_senders.size());
+		for (std::size_t i = 0; i < receiver->m_senders.size(); ++i)
+		{
+			EXPECT_EQ(static_cast<int>(i % 2), receiver->m_senders[i]);
+		}
+	}
+
+	TEST_F(CParallelUpdateTest, destroy_from_parallel_update_is_deferred)
+	{
+		std::vector<ParallelUpdateTestInternal::CCompSelfDestroyer*> destroyers = CreateGameObjectsWithComponent<ParallelUpdateTestInternal::CCompSelfDestroyer>(ParallelUpdateTestInternal::NUM_GAME_OBJECTS);
+		std::vector<CHandle> handles;
+		for (ParallelUpdateTestInternal::CCompSelfDestroyer* destroyer : destroyers)
+		{
+			handles.emplace_back(destroyer->GetOwner());
+		}
+
+		CDonerComponentsSystems::Get()->Update(0.f);
+
+		for (CHandle handle : handles)
+		{
+			EXPECT_FALSE(handle);
+		}
+	}
+
+	TEST_F(CParallelUpdateTest, remove_component_from_parallel_update_is_deferred)
+	{
+		ParallelUpdateTestInternal::s_removerDestroys = 0;
+		std::vector<CHandle> owners;
+		for (ParallelUpdateTestInternal::CCompSelfRemover* remover : CreateGameObjectsWithComponent<ParallelUpdateTestInternal::CCompSelfRemover>(ParallelUpdateTestInternal::NUM_GAME_OBJECTS))
+		{
+			owners.emplace_back(remover->GetOwner());
+		}
+		CreateGameObjectsWithComponent<ParallelUpdateTestInternal::CCompWriter>(ParallelUpdateTestInternal::NUM_GAME_OBJECTS);
+
+		CDonerComponentsSystems::Get()->Update(0.f);
+
+		EXPECT_EQ(ParallelUpdateTestInternal::NUM_GAME_OBJECTS, ParallelUpdateTestInternal::s_removerDestroys);
+		for (CHandle owner : owners)
+		{
+			CGameObject* gameObject = owner;
+			ASSERT_NE(nullptr, gameObject);
+			EXPECT_FALSE(static_cast<bool>(gameObject->GetComponent<ParallelUpdateTestInternal::CCompSelfRemover>()));
+		}
+	}
+
+	TEST_F(CParallelUpdateTest, component_destructors_run_on_main_thread_by_default)
+	{
+		ParallelUpdateTestInternal::s_mainThreadId = std::this_thread::get_id();
+		ParallelUpdateTestInternal::s_workerDestructions = 0;
+		std::vector<CHandle> handles;
+		for (CComponent* component : CreateGameObjectsWithComponent<ParallelUpdateTestInternal::CCompDestructionTracker<0>>(ParallelUpdateTestInternal::NUM_GAME_OBJECTS))
+		{
+			handles.emplace_back(component);
+		}
+		for (CComponent* component : CreateGameObjectsWithComponent<ParallelUpdateTestInternal::CCompDestructionTracker<1>>(ParallelUpdateTestInternal::NUM_GAME_OBJECTS))
+		{
+			handles.emplace_back(component);
+		}
+
+		for (CHandle handle : handles)
+		{
+			static_cast<CComponent*>(handle)->GetOwner().Destroy();
+		}
+		CDonerComponentsSystems::Get()->Update(0.f);
+
+		EXPECT_EQ(0, ParallelUpdateTestInternal::s_workerDestructions);
+		for (CHandle handle : handles)
+		{
+			EXPECT_FALSE(handle);
+		}
+	}
+
+	TEST_F(CParallelUpdateTest, parallel_destroys_destroy_all_components)
+	{
+		CComponentFactoryManager* componentFactoryManager = CDonerComponentsSystems::Get()->GetComponentFactoryManager();
+		EXPECT_TRUE(componentFactoryManager->SetParallelDestroysEnabled<ParallelUpdateTestInternal::CCompDestructionTracker<0>>(true));
+		EXPECT_TRUE(componentFactoryManager->SetParallelDestroysEnabled<ParallelUpdateTestInternal::CCompDestructionTracker<1>>(true));
+
+		std::vector<CHandle> handles;
+		for (CComponent* component : CreateGameObjectsWithComponent<ParallelUpdateTestInternal::CCompDestructionTracker<0>>(ParallelUpdateTestInternal::NUM_GAME_OBJECTS))
+		{
+			handles.emplace_back(component);
+		}
+		for (CComponent* component : CreateGameObjectsWithComponent<ParallelUpdateTestInternal::CCompDestructionTracker<1>>(ParallelUpdateTestInternal::NUM_GAME_OBJECTS))
+		{
+			handles.emplace_back(component);
+		}
+
+		for (CHandle handle : handles)
+		{
+			static_cast<CComponent*>(handle)->GetOwner().Destroy();
+		}
+		CDonerComponentsSystems::Get()->Update(0.f);
+
+		for (CHandle handle : handles)
+		{
+			EXPECT_FALSE(handle);
+		}
+	}
+
+	TEST_F(CParallelUpdateTest, chunked_update_updates_all_components)
+	{
+		std::vector<ParallelUpdateTestInternal::CCompChunked*> components = CreateGameObjectsWithComponent<ParallelUpdateTestInternal::CCompChunked>(ParallelUpdateTestInternal::NUM_CHUNKED_COMPONENTS);
+
+		for (int i = 0; i < ParallelUpdateTestInternal::LOOP_COUNT; ++i)
+		{
+			CDonerComponentsSystems::Get()->Update(0.f);
+		}
+
+		for (ParallelUpdateTestInternal::CCompChunked* component : components)
+		{
+			EXPECT_EQ(ParallelUpdateTestInternal::LOOP_COUNT, component->m_updateCount);
+		}
+	}
+
+	TEST_F(CParallelUpdateTest, chunked_update_of_a_sparse_pool_updates_the_live_components)
+	{
+		std::vector<ParallelUpdateTestInternal::CCompChunked*> components = CreateGameObjectsWithComponent<ParallelUpdateTestInternal::CCompChunked>(ParallelUpdateTestInternal::NUM_CHUNKED_COMPONENTS);
+		std::vector<ParallelUpdateTestInternal::CCompChunked*> survivors;
+		for (std::size_t i = 0; i < components.size(); ++i)
+		{
+			if (i % 40 == 7)
+			{
+				survivors.emplace_back(components[i]);
+			}
+			else
+			{
+				CGameObject* owner = components[i]->GetOwner();
+				owner->Destroy();
+			}
+		}
+		CDonerComponentsSystems::Get()->Update(0.f);
+		for (ParallelUpdateTestInternal::CCompChunked* survivor : survivors)
+		{
+			survivor->m_updateCount = 0;
+		}
+
+		for (int i = 0; i < ParallelUpdateTestInternal::LOOP_COUNT; ++i)
+		{
+			CDonerComponentsSystems::Get()->Update(0.f);
+		}
+
+		for (ParallelUpdateTestInternal::CCompChunked* survivor : survivors)
+		{
+			EXPECT_EQ(ParallelUpdateTestInternal::LOOP_COUNT, survivor->m_updateCount);
+		}
+	}
+
+	TEST_F(CParallelUpdateTest, chunked_update_post_messages_keep_pool_order)
+	{
+		std::vector<ParallelUpdateTestInternal::CCompChunked*> components = CreateGameObjectsWithComponent<ParallelUpdateTestInternal::CCompChunked>(ParallelUpdateTestInternal::NUM_CHUNKED_COMPONENTS);
+		for (std::size_t i = 0; i < components.size(); ++i)
+		{
+			components[i]->m_id = static_cast<int>(i);
+		}
+
+		CGameObject* gameObject = m_gameObjectManager->CreateGameObject();
+		ParallelUpdateTestInternal::CCompReceiver* receiver = gameObject->AddComponent<ParallelUpdateTestInternal::CCompReceiver>();
+		gameObject->Init();
+		gameObject->Activate();
+		ParallelUpdateTestInternal::CCompChunked::s_receiver = gameObject;
+
+		CDonerComponentsSystems::Get()->Update(0.f);
+
+		ASSERT_EQ(components.size(), receiver->m_senders.size());
+		for (std::size_t i = 0; i < receiver->m_senders.size(); ++i)
+		{
+			EXPECT_EQ(static_cast<int>(i), receiver->m_senders[i]);
+		}
+		ParallelUpdateTestInternal::CCompChunked::s_receiver = CHandle();
+	}
+
+	TEST_F(CParallelUpdateTest, post_messages_from_jobs_are_sent_in_next_SendPostMsgs)
+	{
+		CGameObject* gameObject = m_gameObjectManager->CreateGameObject();
+		ParallelUpdateTestInternal::CCompReceiver* receiver = gameObject->AddComponent<ParallelUpdateTestInternal::CCompReceiver>();
+		gameObject->Init();
+		gameObject->Activate();
+
+		// Sent by job submission order and then by posting order, whichever worker ran each job
+		const int numJobs = 1000;
+		const int numPostsPerJob = 3;
+		CHandle receiverHandle = gameObject;
+		for (int loop = 0; loop < ParallelUpdateTestInternal::LOOP_COUNT; ++loop)
+		{
+			receiver->m_senders.clear();
+			CDonerComponentsSystems::Get()->GetJobSystem()->ParallelFor(numJobs, [receiverHandle, numPostsPerJob](std::size_t i)
+			{
+				CHandle handle = receiverHandle;
+				for (int j = 0; j < numPostsPerJob; ++j)
+				{
+					handle.PostMessage(ParallelUpdateTestInternal::SOrderMessage(static_cast<int>(i) * numPostsPerJob + j));
+				}
+			});
+			EXPECT_TRUE(receiver->m_senders.empty());
+
+			m_gameObjectManager->SendPostMsgs();
+			ASSERT_EQ(static_cast<std::size_t>(numJobs * numPostsPerJob), receiver->m_senders.size());
+			for (std::size_t i = 0; i < receiver->m_senders.size(); ++i)
+			{
+				EXPECT_EQ(static_cast<int>(i), receiver->m_senders[i]);
+			}
+		}
+	}
+
+	TEST_F(CParallelUpdateTest, post_messages_from_jobs_running_during_SendPostMsgs_are_kept)
+	{
+		CGameObject* gameObject = m_gameObjectManager->CreateGameObject();
+		ParallelUpdateTestInternal::CCompReceiver* receiver = gameObject->AddComponent<ParallelUpdateTestInternal::CCompReceiver>();
+		gameObject->Init();
+		gameObject->Activate();
+
+		const int numJobs = 200;
+		const int numPostsPerJob = 50;
+		std::atomic<int> remainingJobs(numJobs);
+		CHandle receiverHandle = gameObject;
+		for (int i = 0; i < numJobs; ++i)
+		{
+			CDonerComponentsSystems::Get()->GetJobSystem()->Submit([receiverHandle, numPostsPerJob, &remainingJobs]()
+			{
+				CHandle handle = receiverHandle;
+				for (int j = 0; j < numPostsPerJob; ++j)
+				{
+					handle.PostMessage(ParallelUpdateTestInternal::SOrderMessage(j));
+				}
+				--remainingJobs;
+			});
+		}
+		while (remainingJobs > 0)
+		{
+			m_gameObjectManager->SendPostMsgs();
+		}
+		m_gameObjectManager->SendPostMsgs();
+
+		EXPECT_EQ(static_cast<std::size_t>(numJobs * numPostsPerJob), receiver->m_senders.size());
+	}
+
+	TEST_F(CParallelUpdateTest, coalesced_post_messages_from_jobs_keep_the_first_submitted)
+	{
+		CGameObject* gameObject = m_gameObjectManager->CreateGameObject();
+		ParallelUpdateTestInternal::CCompReceiver* receiver = gameObject->AddComponent<ParallelUpdateTestInternal::CCompReceiver>();
+		gameObject->Init();
+		gameObject->Activate();
+
+		const int numJobs = 1000;
+		CHandle receiverHandle = gameObject;
+		for (int loop = 0; loop < ParallelUpdateTestInternal::LOOP_COUNT; ++loop)
+		{
+			receiver->m_senders.clear();
+			CDonerComponentsSystems::Get()->GetJobSystem()->ParallelFor(numJobs, [receiverHandle](std::size_t i)
+			{
+				CHandle handle = receiverHandle;
+				handle.PostMessage(ParallelUpdateTestInternal::SCoalescedOrderMessage(static_cast<int>(i)));
+			});
+
+			m_gameObjectManager->SendPostMsgs();
+			EXPECT_EQ(std::vector<int>(1, 0), receiver->m_senders);
+		}
+	}
+
+	TEST_F(CParallelUpdateTest, coalesced_post_messages_from_command_buffers_combine_in_merge_order)
+	{
+		CGameObject* gameObject = m_gameObjectManager->CreateGameObject();
+		ParallelUpdateTestInternal::CCompReceiver* receiver = gameObject->AddComponent<ParallelUpdateTestInternal::CCompReceiver>();
+		gameObject->Init();
+		gameObject->Activate();
+
+		CCommandBuffer first;
+		first.PostMessage(gameObject, ParallelUpdateTestInternal::SCoalescedSubtractMessage(1));
+		first.PostMessage(gameObject, ParallelUpdateTestInternal::SCoalescedSubtractMessage(2));
+		CCommandBuffer second;
+		second.PostMessage(gameObject, ParallelUpdateTestInternal::SCoalescedSubtractMessage(3));
+		second.PostMessage(gameObject, ParallelUpdateTestInternal::SCoalescedSubtractMessage(4));
+		first.Append(second);
+		first.Execute();
+
+		m_gameObjectManager->SendPostMsgs();
+		EXPECT_EQ(std::vector<int>(1, ((1 - 2) - 3) - 4), receiver->m_senders);
+	}
+}
@@ -0,0 +1,453 @@
+////////////////////////////////////////////////////////////
+//
+// MIT License
+//
+// DonerComponents
+// Copyright(c) 2017 Donerkebap13
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+#include <donercomponents/CDonerComponentsSystems.h>
+#include <donercomponents/component/CComponent.h>
+#include <donercomponents/component/CComponentFactoryManager.h>
+#include <donercomponents/gameObject/CGameObject.h>
+#include <donercomponents/messages/CPostMsgQueue.h>
+#include <donercomponents/messages/CPostMsgTimingWheel.h>
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace DonerComponents
+{
+	namespace PostMsgQueueTestInternal
+	{
+		struct SDirtyMessage
+		{};
+
+		struct SDamageMessage
+		{
+			SDamageMessage(int damage) : m_damage(damage) {}
+			int m_damage;
+		};
+	}
+
+	template<>
+	struct SPostMsgCoalescer<PostMsgQueueTestInternal::SDamageMessage>
+	{
+		static void Coalesce(PostMsgQueueTestInternal::SDamageMessage& pending, const PostMsgQueueTestInternal::SDamageMessage& incoming)
+		{
+			pending.m_damage += incoming.m_damage;
+		}
+	};
+}
+
+DONER_DECLARE_POST_MESSAGE_AS_COALESCED(DonerComponents::PostMsgQueueTestInternal::SDirtyMessage)
+DONER_DECLARE_POST_MESSAGE_AS_COALESCED(DonerComponents::PostMsgQueueTestInternal::SDamageMessage)
+
+namespace DonerComponents
+{
+	namespace PostMsgQueueTestInternal
+	{
+		struct SValueMessage
+		{
+			SValueMessage(int value) : m_value(value) {}
+			int m_value;
+		};
+
+		struct SOtherMessage
+		{
+			SOtherMessage(int value) : m_value(value) {}
+			int m_value;
+		};
+
+		struct SCountedMessage
+		{
+			SCountedMessage() { ++s_alive; }
+			SCountedMessage(const SCountedMessage&) { ++s_alive; }
+			~SCountedMessage() { --s_alive; }
+
+			static int s_alive;
+		};
+
+		int SCountedMessage::s_alive = 0;
+
+		struct SBigMessage
+		{
+			char m_data[CPostMsgQueue::DEFAULT_BLOCK_SIZE * 2];
+		};
+
+		class CCompReceiver : public CComponent
+		{
+		public:
+			void RegisterMessages() override
+			{
+				RegisterMessage(&CCompReceiver::OnValueMessage);
+				RegisterMessage(&CCompReceiver::OnBigMessage);
+				RegisterMessage(&CCompReceiver::OnOtherMessage);
+				RegisterMessage(&CCompReceiver::OnDirtyMessage);
+				RegisterMessage(&CCompReceiver::OnDamageMessage);
+			}
+
+			void OnDirtyMessage(const SDirtyMessage& /*message*/)
+			{
+				m_received.push_back(0);
+			}
+
+			void OnDamageMessage(const SDamageMessage& message)
+			{
+				m_received.push_back(message.m_damage);
+			}
+
+			void OnValueMessage(const SValueMessage& message)
+			{
+				m_received.push_back(message.m_value);
+			}
+
+			void OnOtherMessage(const SOtherMessage& message)
+			{
+				m_received.push_back(-message.m_value);
+			}
+
+			void OnBigMessage(const SBigMessage& message)
+			{
+				m_received.push_back(message.m_data[0]);
+			}
+
+			std::vector<int> m_received;
+		};
+	}
+
+	class CPostMsgQueueTest : public ::testing::Test
+	{
+	public:
+		CPostMsgQueueTest()
+			: m_gameObject(nullptr)
+			, m_receiver(nullptr)
+		{
+			CDonerComponentsSystems& systems = CDonerComponentsSystems::CreateInstance()->Init();
+			ADD_COMPONENT_FACTORY("receiver", PostMsgQueueTestInternal::CCompReceiver, 2);
+
+			m_gameObject = systems.GetGameObjectManager()->CreateGameObject();
+			m_receiver = m_gameObject->AddComponent<PostMsgQueueTestInternal::CCompReceiver>();
+			m_gameObject->Init();
+			m_gameObject->Activate();
+		}
+
+		~CPostMsgQueueTest()
+		{
+			CDonerComponentsSystems::DestroyInstance();
+		}
+
+		CGameObject* m_gameObject;
+		PostMsgQueueTestInternal::CCompReceiver* m_receiver;
+	};
+
+	TEST_F(CPostMsgQueueTest, messages_are_sent_in_posting_order)
+	{
+		CPostMsgQueue queue(64);
+		for (int i = 0; i < 100; ++i)
+		{
+			queue.Push(m_gameObject, PostMsgQueueTestInternal::SValueMessage(i));
+		}
+		EXPECT_EQ(100, queue.GetSize());
+
+		queue.SendAll();
+		EXPECT_TRUE(queue.IsEmpty());
+		ASSERT_EQ(100, m_receiver->m_received.size());
+		for (int i = 0; i < 100; ++i)
+		{
+			EXPECT_EQ(i, m_receiver->m_received[i]);
+		}
+	}
+
+	TEST_F(CPostMsgQueueTest, messages_bigger_than_a_block_are_sent)
+	{
+		CPostMsgQueue queue;
+		PostMsgQueueTestInternal::SBigMessage message;
+		message.m_data[0] = 7;
+		queue.Push(m_gameObject, PostMsgQueueTestInternal::SValueMessage(1));
+		queue.Push(m_gameObject, message);
+		queue.Push(m_gameObject, PostMsgQueueTestInternal::SValueMessage(2));
+
+		queue.SendAll();
+		std::vector<int> expected = { 1, 7, 2 };
+		EXPECT_EQ(expected, m_receiver->m_received);
+	}
+
+	TEST_F(CPostMsgQueueTest, messages_are_destroyed_after_sending_or_clearing)
+	{
+		CPostMsgQueue queue;
+		queue.Push(m_gameObject, PostMsgQueueTestInternal::SCountedMessage());
+		queue.Push(m_gameObject, PostMsgQueueTestInternal::SCountedMessage());
+		EXPECT_EQ(2, PostMsgQueueTestInternal::SCountedMessage::s_alive);
+		queue.SendAll();
+		EXPECT_EQ(0, PostMsgQueueTestInternal::SCountedMessage::s_alive);
+
+		queue.Push(m_gameObject, PostMsgQueueTestInternal::SCountedMessage());
+		queue.Clear();
+		EXPECT_EQ(0, PostMsgQueueTestInternal::SCountedMessage::s_alive);
+	}
+
+	TEST_F(CPostMsgQueueTest, moved_messages_are_appended_to_the_other_queue)
+	{
+		CPostMsgQueue queue;
+		CPostMsgQueue other;
+		other.Push(m_gameObject, PostMsgQueueTestInternal::SValueMessage(1));
+		queue.Push(m_gameObject, PostMsgQueueTestInternal::SValueMessage(2));
+		queue.Push(m_gameObject, PostMsgQueueTestInternal::SValueMessage(3));
+
+		queue.MoveTo(other);
+		EXPECT_TRUE(queue.IsEmpty());
+		EXPECT_EQ(3, other.GetSize());
+
+		other.SendAll();
+		std::vector<int> expected = { 1, 2, 3 };
+		EXPECT_EQ(expected, m_receiver->m_received);
+	}
+
+	TEST_F(CPostMsgQueueTest, batched_messages_are_grouped_by_type_keeping_posting_order)
+	{
+		CPostMsgQueue queue;
+		queue.Push(m_gameObject, PostMsgQueueTestInternal::SValueMessage(1));
+		queue.Push(m_gameObject, PostMsgQueueTestInternal::SOtherMessage(2));
+		queue.Push(m_gameObject, PostMsgQueueTestInternal::SValueMessage(3));
+		queue.Push(m_gameObject, PostMsgQueueTestInternal::SOtherMessage(4));
+
+		queue.SendAllBatched();
+		EXPECT_TRUE(queue.IsEmpty());
+		ASSERT_EQ(4, m_receiver->m_received.size());
+		// Groups are ordered by message type index, posting order is kept inside each group
+		bool valueFirst = CTypeHasher::Index<PostMsgQueueTestInternal::SValueMessage>() < CTypeHasher::Index<PostMsgQueueTestInternal::SOtherMessage>();
+		std::vector<int> expected = valueFirst ? std::vector<int>{ 1, 3, -2, -4 } : std::vector<int>{ -2, -4, 1, 3 };
+		EXPECT_EQ(expected, m_receiver->m_received);
+	}
+
+	TEST_F(CPostMsgQueueTest, batched_postMessages_reach_every_game_object)
+	{
+		CGameObjectManager* gameObjectManager = CDonerComponentsSystems::Get()->GetGameObjectManager();
+		gameObjectManager->SetPostMsgDelivery(EPostMsgDelivery::Batched);
+
+		CGameObject* gameObject2 = gameObjectManager->CreateGameObject();
+		PostMsgQueueTestInternal::CCompReceiver* receiver2 = gameObject2->AddComponent<PostMsgQueueTestInternal::CCompReceiver>();
+		gameObject2->Init();
+		gameObject2->Activate();
+
+		gameObject2->PostMessage(PostMsgQueueTestInternal::SValueMessage(1));
+		m_gameObject->PostMessage(PostMsgQueueTestInternal::SValueMessage(2));
+		gameObject2->PostMessage(PostMsgQueueTestInternal::SValueMessage(3));
+		EXPECT_TRUE(m_receiver->m_received.empty());
+
+		gameObjectManager->SendPostMsgs();
+		EXPECT_EQ(std::vector<int>{ 2 }, m_receiver->m_received);
+		std::vector<int> expected = { 1, 3 };
+		EXPECT_EQ(expected, receiver2->m_received);
+	}
+
+	TEST_F(CPostMsgQueueTest, delayed_messages_wait_their_ticks_at_any_level)
+	{
+		CPostMsgTimingWheel timingWheel(1.f);
+		CPostMsgQueue queue;
+		const std::vector<int> delays = { 0, 2, 63, 64, 65, 4097, 300000 };
+		for (int delay : delays)
+		{
+			timingWheel.Push(m_gameObject, PostMsgQueueTestInternal::SValueMessage(delay), static_cast<float>(delay));
+		}
+		EXPECT_EQ(delays.size(), timingWheel.GetSize());
+
+		// Delays are waited in whole ticks, at least one
+		std::vector<int> sentTicks;
+		for (int tick = 1; tick <= delays.back(); ++tick)
+		{
+			timingWheel.Advance(1.f, queue);
+			queue.SendAll();
+			while (sentTicks.size() < m_receiver->m_received.size())
+			{
+				sentTicks.push_back(tick);
+			}
+		}
+
+		EXPECT_EQ(delays, m_receiver->m_received);
+		std::vector<int> expectedTicks = { 1, 2, 63, 64, 65, 4097, 300000 };
+		EXPECT_EQ(expectedTicks, sentTicks);
+		EXPECT_EQ(0, timingWheel.GetSize());
+	}
+
+	TEST_F(CPostMsgQueueTest, delayed_messages_crossing_the_top_level_range_are_sent_in_time)
+	{
+		CPostMsgTimingWheel timingWheel(1.f);
+		CPostMsgQueue queue;
+		const std::uint64_t topLevelRange = std::uint64_t(1) << (CPostMsgTimingWheel::SLOT_BITS * CPostMsgTimingWheel::NUM_LEVELS);
+
+		// Out of range for every level, waits in the overflow until the top level wraps around
+		timingWheel.Push(m_gameObject, PostMsgQueueTestInternal::SValueMessage(1), static_cast<float>(topLevelRange + 4));
+		timingWheel.Advance(static_cast<float>(topLevelRange - 1), queue);
+		queue.SendAll();
+		EXPECT_TRUE(m_receiver->m_received.empty());
+
+		// Due right after the top level wraps around
+		timingWheel.Push(m_gameObject, PostMsgQueueTestInternal::SValueMessage(2), 2.f);
+		timingWheel.Advance(1.f, queue);
+		queue.SendAll();
+		EXPECT_TRUE(m_receiver->m_received.empty());
+		timingWheel.Advance(1.f, queue);
+		queue.SendAll();
+		EXPECT_EQ(std::vector<int>{ 2 }, m_receiver->m_received);
+
+		timingWheel.Advance(2.f, queue);
+		queue.SendAll();
+		EXPECT_EQ(std::vector<int>{ 2 }, m_receiver->m_received);
+		timingWheel.Advance(1.f, queue);
+		queue.SendAll();
+		std::vector<int> expected = { 2, 1 };
+		EXPECT_EQ(expected, m_receiver->m_received);
+		EXPECT_EQ(0, timingWheel.GetSize());
+	}
+
+	TEST_F(CPostMsgQueueTest, invalid_delays_are_clamped)
+	{
+		CPostMsgTimingWheel timingWheel(1.f);
+		CPostMsgQueue queue;
+		timingWheel.Push(m_gameObject, PostMsgQueueTestInternal::SValueMessage(1), std::numeric_limits<float>::quiet_NaN());
+		timingWheel.Push(m_gameObject, PostMsgQueueTestInternal::SValueMessage(2), -5.f);
+		timingWheel.Push(m_gameObject, PostMsgQueueTestInternal::SValueMessage(3), std::numeric_limits<float>::infinity());
+
+		timingWheel.Advance(1.f, queue);
+		queue.SendAll();
+		std::vector<int> expected = { 1, 2 };
+		EXPECT_EQ(expected, m_receiver->m_received);
+		EXPECT_EQ(1, timingWheel.GetSize());
+	}
+
+	TEST_F(CPostMsgQueueTest, delayed_postMessage_is_sent_in_the_update_its_delay_expires)
+	{
+		CGameObjectManager* gameObjectManager = CDonerComponentsSystems::Get()->GetGameObjectManager();
+		gameObjectManager->PostMessageDelayed(m_gameObject, PostMsgQueueTestInternal::SValueMessage(1), 0.5f);
+		gameObjectManager->PostMessageDelayed(m_gameObject, PostMsgQueueTestInternal::SValueMessage(2), 2.f);
+		EXPECT_EQ(2, gameObjectManager->GetDelayedPostMsgsCount());
+
+		CDonerComponentsSystems::Get()->Update(0.25f);
+		EXPECT_TRUE(m_receiver->m_received.empty());
+
+		CDonerComponentsSystems::Get()->Update(0.3f);
+		EXPECT_EQ(std::vector<int>{ 1 }, m_receiver->m_received);
+
+		CDonerComponentsSystems::Get()->Update(1.5f);
+		std::vector<int> expected = { 1, 2 };
+		EXPECT_EQ(expected, m_receiver->m_received);
+		EXPECT_EQ(0, gameObjectManager->GetDelayedPostMsgsCount());
+	}
+
+	TEST_F(CPostMsgQueueTest, postMessages_are_sent_by_priority)
+	{
+		CGameObjectManager* gameObjectManager = CDonerComponentsSystems::Get()->GetGameObjectManager();
+		m_gameObject->PostMessage(PostMsgQueueTestInternal::SValueMessage(1), ESendMessageType::NonRecursive, EPostMsgPriority::Low);
+		m_gameObject->PostMessage(PostMsgQueueTestInternal::SValueMessage(2));
+		m_gameObject->PostMessage(PostMsgQueueTestInternal::SValueMessage(3), ESendMessageType::NonRecursive, EPostMsgPriority::High);
+
+		gameObjectManager->SendPostMsgs();
+		std::vector<int> expected = { 3, 2, 1 };
+		EXPECT_EQ(expected, m_receiver->m_received);
+	}
+
+	TEST_F(CPostMsgQueueTest, low_priority_postMessages_over_budget_are_carried_over_in_order)
+	{
+		CGameObjectManager* gameObjectManager = CDonerComponentsSystems::Get()->GetGameObjectManager();
+		gameObjectManager->SetPostMsgBudget(3);
+
+		for (int i = 0; i < 5; ++i)
+		{
+			m_gameObject->PostMessage(PostMsgQueueTestInternal::SValueMessage(i), ESendMessageType::NonRecursive, EPostMsgPriority::Low);
+		}
+		m_gameObject->PostMessage(PostMsgQueueTestInternal::SValueMessage(10), ESendMessageType::NonRecursive, EPostMsgPriority::High);
+
+		gameObjectManager->SendPostMsgs();
+		std::vector<int> expected = { 10, 0, 1 };
+		EXPECT_EQ(expected, m_receiver->m_received);
+		EXPECT_EQ(3, gameObjectManager->GetCarriedPostMsgsCount());
+
+		m_gameObject->PostMessage(PostMsgQueueTestInternal::SValueMessage(5), ESendMessageType::NonRecursive, EPostMsgPriority::Low);
+		gameObjectManager->SendPostMsgs();
+		expected = { 10, 0, 1, 2, 3, 4 };
+		EXPECT_EQ(expected, m_receiver->m_received);
+		EXPECT_EQ(1, gameObjectManager->GetCarriedPostMsgsCount());
+
+		gameObjectManager->SetPostMsgBudget(0);
+		gameObjectManager->SendPostMsgs();
+		expected = { 10, 0, 1, 2, 3, 4, 5 };
+		EXPECT_EQ(expected, m_receiver->m_received);
+		EXPECT_EQ(0, gameObjectManager->GetCarriedPostMsgsCount());
+	}
+
+	TEST_F(CPostMsgQueueTest, coalesced_messages_are_sent_once_per_game_object)
+	{
+		CGameObject* gameObject2 = CDonerComponentsSystems::Get()->GetGameObjectManager()->CreateGameObject();
+		PostMsgQueueTestInternal::CCompReceiver* receiver2 = gameObject2->AddComponent<PostMsgQueueTestInternal::CCompReceiver>();
+		gameObject2->Init();
+		gameObject2->Activate();
+
+		CPostMsgQueue queue;
+		for (int i = 0; i < 100; ++i)
+		{
+			queue.Push(m_gameObject, PostMsgQueueTestInternal::SDirtyMessage());
+			queue.Push(gameObject2, PostMsgQueueTestInternal::SDirtyMessage());
+		}
+		queue.Push(m_gameObject, PostMsgQueueTestInternal::SValueMessage(1));
+		queue.Push(m_gameObject, PostMsgQueueTestInternal::SValueMessage(1));
+		EXPECT_EQ(4, queue.GetSize());
+
+		queue.SendAll();
+		std::vector<int> expected = { 0, 1, 1 };
+		EXPECT_EQ(expected, m_receiver->m_received);
+		EXPECT_EQ(std::vector<int>{ 0 }, receiver2->m_received);
+
+		// Once sent, a new message is queued again
+		queue.Push(m_gameObject, PostMsgQueueTestInternal::SDirtyMessage());
+		EXPECT_EQ(1, queue.GetSize());
+
+		for (int i = 0; i < 200; ++i)
+		{
+			CGameObject* gameObject = CDonerComponentsSystems::Get()->GetGameObjectManager()->CreateGameObject();
+			queue.Push(gameObject, PostMsgQueueTestInternal::SDirtyMessage());
+			queue.Push(gameObject, PostMsgQueueTestInternal::SDirtyMessage());
+		}
+		queue.Push(m_gameObject, PostMsgQueueTestInternal::SDirtyMessage());
+		EXPECT_EQ(201, queue.GetSize());
+	}
+
+	TEST_F(CPostMsgQueueTest, coalesced_messages_are_merged_with_the_coalescer)
+	{
+		CPostMsgQueue queue;
+		CPostMsgQueue other;
+		queue.Push(m_gameObject, PostMsgQueueTestInternal::SDamageMessage(1));
+		queue.Push(m_gameObject, PostMsgQueueTestInternal::SDamageMessage(2));
+		other.Push(m_gameObject, PostMsgQueueTestInternal::SDamageMessage(4));
+
+		// Moving coalesces too, so messages posted from several threads are merged as well
+		other.MoveTo(queue);
+		EXPECT_EQ(1, queue.GetSize());
+
+		queue.SendAll();
+		EXPECT_EQ(std::vector<int>{ 7 }, m_receiver->m_received);
+	}
+}
@@ -0,0 +1,99 @@
+////////////////////////////////////////////////////////////
+//
+// MIT License
+//
+// DonerComponents
+// Copyright(c) 2017 Donerkebap13
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+#include <donercomponents/utils/hash/CTypeHasher.h>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+	struct SAnonymousFoo {};
+}
+
+namespace DonerComponents
+{
+	namespace TypeHasherTestInternal
+	{
+		struct SFoo {};
+		struct SBar {};
+		namespace Other
+		{
+			struct SFoo {};
+		}
+
+		constexpr CTypeHasher::HashId FOO_HASH = CTypeHasher::Hash<SFoo>();
+
+		// Defined in CTypeHasherTestOtherUnit.cpp
+		CTypeHasher::TypeIndex GetOtherUnitAnonymousFooIndex();
+	}
+
+	class CTypeHasherTest : public ::testing::Test
+	{
+	};
+
+	TEST_F(CTypeHasherTest, hash_computed_at_compile_time)
+	{
+		static_assert(TypeHasherTestInternal::FOO_HASH == CTypeHasher::Hash<TypeHasherTestInternal::SFoo>(), "Hash must be constexpr");
+		EXPECT_EQ(TypeHasherTestInternal::FOO_HASH, CTypeHasher::Hash<TypeHasherTestInternal::SFoo>());
+	}
+
+	TEST_F(CTypeHasherTest, different_types_have_different_hashes)
+	{
+		EXPECT_NE(CTypeHasher::Hash<TypeHasherTestInternal::SFoo>(), CTypeHasher::Hash<TypeHasherTestInternal::SBar>());
+		EXPECT_NE(CTypeHasher::Hash<TypeHasherTestInternal::SFoo>(), CTypeHasher::Hash<TypeHasherTestInternal::Other::SFoo>());
+	}
+
+	TEST_F(CTypeHasherTest, indices_are_dense_and_stable)
+	{
+		CTypeHasher::TypeIndex fooIdx = CTypeHasher::Index<TypeHasherTestInternal::SFoo>();
+		CTypeHasher::TypeIndex barIdx = CTypeHasher::Index<TypeHasherTestInternal::SBar>();
+
+		EXPECT_NE(fooIdx, barIdx);
+		EXPECT_EQ(fooIdx, CTypeHasher::Index<TypeHasherTestInternal::SFoo>());
+		EXPECT_LT(fooIdx, CTypeHasher::GetNumIndices());
+		EXPECT_LT(barIdx, CTypeHasher::GetNumIndices());
+	}
+
+	TEST_F(CTypeHasherTest, types_with_the_same_name_have_different_indices)
+	{
+		CTypeHasher::TypeIndex fooIdx = CTypeHasher::Index<TypeHasherTestInternal::SFoo>();
+		CTypeHasher::TypeIndex otherFooIdx = CTypeHasher::Index<TypeHasherTestInternal::Other::SFoo>();
+		CTypeHasher::TypeIndex anonymousFooIdx = CTypeHasher::Index<SAnonymousFoo>();
+
+		EXPECT_NE(fooIdx, otherFooIdx);
+		EXPECT_NE(fooIdx, anonymousFooIdx);
+		EXPECT_EQ(anonymousFooIdx, CTypeHasher::Index<SAnonymousFoo>());
+	}
+
+	TEST_F(CTypeHasherTest, anonymous_types_from_different_translation_units_have_different_indices)
+	{
+		CTypeHasher::TypeIndex otherUnitIdx = TypeHasherTestInternal::GetOtherUnitAnonymousFooIndex();
+
+		EXPECT_NE(CTypeHasher::Index<SAnonymousFoo>(), otherUnitIdx);
+		EXPECT_EQ(otherUnitIdx, TypeHasherTestInternal::GetOtherUnitAnonymousFooIndex());
+	}
+}
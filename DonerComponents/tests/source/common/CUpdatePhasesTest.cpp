@@ -0,0 +1,156 @@
+////////////////////////////////////////////////////////////
+//
+// MIT License
+//
+// DonerComponents
+// Copyright(c) 2017 Donerkebap13
+// 
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+// 
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+////////////////////////////////////////////////////////////
+
+#include <donercomponents/CDonerComponentsSystems.h>
+#include <donercomponents/component/CComponent.h>
+#include <donercomponents/component/CComponentFactoryManager.h>
+#include <donercomponents/gameObject/CGameObject.h>
+
+#include <gtest/gtest.h>
+
+namespace DonerComponents
+{
+	namespace UpdatePhasesTestInternal
+	{
+		const float FIXED_DT = 0.5f;
+		const float FRAME_DT = 0.25f;
+
+		int s_updateSequence = 0;
+
+		class CCompPhaseBase : public CComponent
+		{
+		public:
+			CCompPhaseBase() : m_updateCount(0), m_lastSequence(0), m_lastDt(0.f) {}
+
+			void DoUpdate(float dt) override
+			{
+				++m_updateCount;
+				m_lastSequence = ++s_updateSequence;
+				m_lastDt = dt;
+			}
+
+			int m_updateCount;
+			int m_lastSequence;
+			float m_lastDt;
+		};
+
+		class CCompLate : public CCompPhaseBase {};
+		class CCompDefault : public CCompPhaseBase {};
+		class CCompPrePhysics : public CCompPhaseBase {};
+		class CCompPhysics : public CCompPhaseBase {};
+	}
+
+	class CUpdatePhasesTest : public ::testing::Test
+	{
+	public:
+		CUpdatePhasesTest()
+			: m_gameObjectManager(nullptr)
+			, m_componentFactoryManager(nullptr)
+		{
+			CDonerComponentsSystems& systems = CDonerComponentsSystems::CreateInstance()->Init();
+			m_gameObjectManager = systems.GetGameObjectManager();
+			m_componentFactoryManager = systems.GetComponentFactoryManager();
+
+			// Registered in reverse phase order on purpose
+			ADD_COMPONENT_FACTORY("late", UpdatePhasesTestInternal::CCompLate, 1);
+			ADD_COMPONENT_FACTORY("default", UpdatePhasesTestInternal::CCompDefault, 1);
+			ADD_COMPONENT_FACTORY("physics", UpdatePhasesTestInternal::CCompPhysics, 1);
+			ADD_COMPONENT_FACTORY("prePhysics", UpdatePhasesTestInternal::CCompPrePhysics, 1);
+
+			m_componentFactoryManager->SetUpdatePhase<UpdatePhasesTestInternal::CCompLate>(EUpdatePhase::Late);
+			m_componentFactoryManager->SetUpdatePhase<UpdatePhasesTestInternal::CCompPhysics>(EUpdatePhase::Physics);
+			m_componentFactoryManager->SetUpdatePhase<UpdatePhasesTestInternal::CCompPrePhysics>(EUpdatePhase::PrePhysics);
+
+			CGameObject* gameObject = m_gameObjectManager->CreateGameObject();
+			m_late = static_cast<UpdatePhasesTestInternal::CCompLate*>(gameObject->AddComponent<UpdatePhasesTestInternal::CCompLate>());
+			m_default = static_cast<UpdatePhasesTestInternal::CCompDefault*>(gameObject->AddComponent<UpdatePhasesTestInternal::CCompDefault>());
+			m_physics = static_cast<UpdatePhasesTestInternal::CCompPhysics*>(gameObject->AddComponent<UpdatePhasesTestInternal::CCompPhysics>());
+			m_prePhysics = static_cast<UpdatePhasesTestInternal::CCompPrePhysics*>(gameObject->AddComponent<UpdatePhasesTestInternal::CCompPrePhysics>());
+			gameObject->Init();
+			gameObject->Activate();
+		}
+
+		~CUpdatePhasesTest()
+		{
+			CDonerComponentsSystems::DestroyInstance();
+		}
+
+		CGameObjectManager* m_gameObjectManager;
+		CComponentFactoryManager* m_componentFactoryManager;
+		UpdatePhasesTestInternal::CCompLate* m_late;
+		UpdatePhasesTestInternal::CCompDefault* m_default;
+		UpdatePhasesTestInternal::CCompPhysics* m_physics;
+		UpdatePhasesTestInternal::CCompPrePhysics* m_prePhysics;
+	};
+
+	TEST_F(CUpdatePhasesTest, phases_updated_in_order)
+	{
+		CDonerComponentsSystems::Get()->Update(UpdatePhasesTestInternal::FRAME_DT);
+
+		EXPECT_LT(m_prePhysics->m_lastSequence, m_physics->m_lastSequence);
+		EXPECT_LT(m_physics->m_lastSequence, m_default->m_lastSequence);
+		EXPECT_LT(m_default->m_lastSequence, m_late->m_lastSequence);
+	}
+
+	TEST_F(CUpdatePhasesTest, fixed_timestep_phase_accumulates_dt)
+	{
+		m_componentFactoryManager->SetFixedTimestep(EUpdatePhase::Physics, UpdatePhasesTestInternal::FIXED_DT);
+
+		CDonerComponentsSystems::Get()->Update(UpdatePhasesTestInternal::FRAME_DT);
+		EXPECT_EQ(0, m_physics->m_updateCount);
+		EXPECT_EQ(1, m_default->m_updateCount);
+		EXPECT_FLOAT_EQ(0.5f, m_componentFactoryManager->GetFixedTimestepAlpha(EUpdatePhase::Physics));
+
+		CDonerComponentsSystems::Get()->Update(UpdatePhasesTestInternal::FRAME_DT);
+		EXPECT_EQ(1, m_physics->m_updateCount);
+		EXPECT_FLOAT_EQ(UpdatePhasesTestInternal::FIXED_DT, m_physics->m_lastDt);
+		EXPECT_EQ(2, m_default->m_updateCount);
+		EXPECT_FLOAT_EQ(UpdatePhasesTestInternal::FRAME_DT, m_default->m_lastDt);
+		EXPECT_FLOAT_EQ(0.f, m_componentFactoryManager->GetFixedTimestepAlpha(EUpdatePhase::Physics));
+	}
+
+	TEST_F(CUpdatePhasesTest, fixed_timestep_phase_limits_steps_per_update)
+	{
+		m_componentFactoryManager->SetFixedTimestep(EUpdatePhase::Physics, UpdatePhasesTestInternal::FIXED_DT, 2);
+
+		CDonerComponentsSystems::Get()->Update(8 * UpdatePhasesTestInternal::FIXED_DT);
+		EXPECT_EQ(2, m_physics->m_updateCount);
+
+		CDonerComponentsSystems::Get()->Update(UpdatePhasesTestInternal::FRAME_DT);
+		EXPECT_EQ(2, m_physics->m_updateCount);
+	}
+
+	TEST_F(CUpdatePhasesTest, fixed_timestep_disabled_with_zero_dt)
+	{
+		m_componentFactoryManager->SetFixedTimestep(EUpdatePhase::Physics, UpdatePhasesTestInternal::FIXED_DT);
+		m_componentFactoryManager->SetFixedTimestep(EUpdatePhase::Physics, 0.f);
+
+		CDonerComponentsSystems::Get()->Update(UpdatePhasesTestInternal::FRAME_DT);
+		EXPECT_EQ(1, m_physics->m_updateCount);
+		EXPECT_FLOAT_EQ(UpdatePhasesTestInternal::FRAME_DT, m_physics->m_lastDt);
+	}
+}